@@ -0,0 +1,104 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace files {
+// Raw little-endian dump of trivially copyable values.
+// Not portable between architectures, intended for local checkpoints only.
+class BinaryWriter {
+ protected:
+  std::string filename;
+  std::string tmp_filename;
+  std::ofstream f;
+
+ public:
+  // Data is written into temporary file and moved to filename on Close, so
+  // readers never observe partially written file.
+  explicit BinaryWriter(const std::string& _filename)
+      : filename(_filename),
+        tmp_filename(_filename + ".tmp"),
+        f(tmp_filename, std::ios::binary | std::ios::trunc) {}
+
+  bool Good() const { return f.good(); }
+
+  template <class T>
+  void Write(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BinaryWriter::Write requires trivially copyable type");
+    f.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <class T, class A>
+  void WriteVector(const std::vector<T, A>& v) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BinaryWriter::WriteVector requires trivially copyable type");
+    Write<uint64_t>(v.size());
+    f.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+  }
+
+  void WriteString(const std::string& s) {
+    Write<uint64_t>(s.size());
+    f.write(s.data(), s.size());
+  }
+
+  bool Close() {
+    f.close();
+    if (!f) {
+      std::remove(tmp_filename.c_str());
+      return false;
+    }
+    return std::rename(tmp_filename.c_str(), filename.c_str()) == 0;
+  }
+};
+
+class BinaryReader {
+ protected:
+  std::ifstream f;
+
+ public:
+  explicit BinaryReader(const std::string& filename)
+      : f(filename, std::ios::binary) {}
+
+  bool Good() const { return f.good(); }
+
+  template <class T>
+  bool Read(T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BinaryReader::Read requires trivially copyable type");
+    f.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return f.good();
+  }
+
+  template <class T>
+  T Read() {
+    T value{};
+    Read(value);
+    return value;
+  }
+
+  template <class T>
+  bool ReadVector(std::vector<T>& v) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "BinaryReader::ReadVector requires trivially copyable type");
+    uint64_t size = 0;
+    if (!Read(size)) return false;
+    v.resize(size);
+    f.read(reinterpret_cast<char*>(v.data()), size * sizeof(T));
+    return f.good();
+  }
+
+  bool ReadString(std::string& s) {
+    uint64_t size = 0;
+    if (!Read(size)) return false;
+    s.resize(size);
+    f.read(&s[0], size);
+    return f.good();
+  }
+};
+}  // namespace files
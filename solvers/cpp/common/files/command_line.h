@@ -43,6 +43,10 @@ class CommandLine {
     }
   }
 
+  bool HasInt(const std::string& key) const {
+    return args_int.find(key) != args_int.end();
+  }
+
   int GetInt(const std::string& key) const {
     auto it = args_int.find(key);
     assert(it != args_int.end());
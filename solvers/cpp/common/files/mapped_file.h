@@ -0,0 +1,82 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <string_view>
+
+namespace files {
+// Read-only memory mapping of whole file.
+// Empty and missing files give empty view, Good() distinguishes them.
+class MappedFile {
+ protected:
+  const char* data = nullptr;
+  size_t size = 0;
+  bool good = false;
+
+ public:
+  MappedFile() {}
+
+  explicit MappedFile(const std::string& filename) { Open(filename); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& r) : data(r.data), size(r.size), good(r.good) {
+    r.data = nullptr;
+    r.size = 0;
+    r.good = false;
+  }
+
+  MappedFile& operator=(MappedFile&& r) {
+    if (this != &r) {
+      Close();
+      std::swap(data, r.data);
+      std::swap(size, r.size);
+      std::swap(good, r.good);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { Close(); }
+
+  bool Open(const std::string& filename) {
+    Close();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+      size = size_t(st.st_size);
+      if (size == 0) {
+        good = true;
+      } else {
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+          // Files are parsed front to back.
+          madvise(p, size, MADV_SEQUENTIAL);
+          data = static_cast<const char*>(p);
+          good = true;
+        } else {
+          size = 0;
+        }
+      }
+    }
+    close(fd);
+    return good;
+  }
+
+  void Close() {
+    if (data) munmap(const_cast<char*>(data), size);
+    data = nullptr;
+    size = 0;
+    good = false;
+  }
+
+  bool Good() const { return good; }
+  size_t Size() const { return size; }
+  std::string_view View() const { return std::string_view(data, size); }
+};
+}  // namespace files
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common/geometry/d2/point.h"
+#include "common/string/utils/parse_integers.h"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace geometry {
+namespace d2 {
+// Reads points "x y" from text, one pass without per-line allocations.
+// Returns false (v is cleared) for invalid or out of range coordinate and
+// for unpaired last coordinate, so coordinates are never shifted.
+template <class T>
+inline bool ParsePoints(std::string_view s, std::vector<Point<T>>& v) {
+  v.clear();
+  // Usually one point per line.
+  v.reserve(std::count(s.begin(), s.end(), '\n') + 1);
+  T x = T();
+  bool has_x = false;
+  bool ok = ParseIntegers<T>(s, [&](T value) {
+    if (has_x) {
+      v.emplace_back(x, value);
+    } else {
+      x = value;
+    }
+    has_x = !has_x;
+    return true;
+  });
+  if (!ok || has_x) {
+    v.clear();
+    return false;
+  }
+  return true;
+}
+}  // namespace d2
+}  // namespace geometry
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/heap/base/dheap.h"
+#include "common/heap/ext/layered_heap.h"
 
 #include <functional>
 
@@ -8,3 +9,5 @@ template <class TValue>
 using HeapMinOnTop = heap::base::DHeap<4u, TValue, std::less<TValue>>;
 template <class TValue>
 using HeapMaxOnTop = heap::base::DHeap<4u, TValue, std::greater<TValue>>;
+template <class TValue>
+using LayeredHeapMinOnTop = heap::ext::LayeredHeap<HeapMinOnTop<TValue>>;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace heap {
@@ -11,22 +12,29 @@ namespace base {
 // Pop     -- O(d log N / log d)
 // Init    -- O(N)
 // Union   -- O(N)
-template <unsigned d_, class TTData, class TTCompare = std::less<TTData>>
+template <unsigned d_, class TTData, class TTCompare = std::less<TTData>,
+          class TTAllocator = std::allocator<TTData>>
 class DHeap {
  public:
-  const unsigned d = d_;
+  static const unsigned d = d_;
   using TData = TTData;
   using TCompare = TTCompare;
-  using TSelf = DHeap<d_, TData, TCompare>;
+  using TAllocator = TTAllocator;
+  using TSelf = DHeap<d_, TData, TCompare, TAllocator>;
 
  protected:
   TCompare compare;
-  std::vector<TData> data;
+  std::vector<TData, TAllocator> data;
 
  public:
   DHeap() {}
+  explicit DHeap(const TAllocator& allocator) : data(allocator) {}
   explicit DHeap(unsigned expected_size) { data.reserve(expected_size); }
-  explicit DHeap(const std::vector<TData>& v) : data(v) { Heapify(); }
+  explicit DHeap(const std::vector<TData>& v,
+                 const TAllocator& allocator = TAllocator())
+      : data(v.begin(), v.end(), allocator) {
+    Heapify();
+  }
 
   bool Empty() const { return data.empty(); }
   unsigned Size() const { return unsigned(data.size()); }
@@ -39,6 +47,9 @@ class DHeap {
 
   const TData& Top() const { return data[0]; }
 
+  // Values in heap order, e.g. to save heap and restore it later.
+  const std::vector<TData, TAllocator>& Data() const { return data; }
+
   void Pop() {
     data[0] = data.back();
     data.pop_back();
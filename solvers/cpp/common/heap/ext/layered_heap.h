@@ -0,0 +1,144 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace heap {
+namespace ext {
+// Vector of heaps (layers) with segment tree over layer tops.
+// L - number of layers, N - number of values in layer.
+// Memory  -- O(sum N + L)
+// Add     -- O(Add in THeap + log L)
+// Top     -- O(1)
+// Pop     -- O(Pop in THeap + log L)
+// Clear   -- O(Clear in THeap + log L)
+// Best    -- O(log L), leftmost layer with best top in suffix of layers
+// Next    -- O(log L), leftmost non-empty layer in suffix of layers
+template <class TTHeap>
+class LayeredHeap {
+ public:
+  using THeap = TTHeap;
+  using TData = typename THeap::TData;
+  using TCompare = typename THeap::TCompare;
+  using TAllocator = typename THeap::TAllocator;
+  using TSelf = LayeredHeap<THeap>;
+
+ protected:
+  template <class T>
+  using TRebind =
+      typename std::allocator_traits<TAllocator>::template rebind_alloc<T>;
+
+  TCompare compare;
+  TAllocator allocator;
+  std::vector<THeap, TRebind<THeap>> layers;
+  // Number of leaves in segment tree, power of 2.
+  unsigned tree_size = 1;
+  // Best layer in the subtree, Layers() if all layers in subtree are empty.
+  std::vector<unsigned, TRebind<unsigned>> tree;
+  size_t size = 0;
+
+ public:
+  explicit LayeredHeap(const TAllocator& _allocator = TAllocator())
+      : allocator(_allocator), layers(allocator), tree(allocator) {
+    Resize(0);
+  }
+
+  LayeredHeap(unsigned nlayers, const TAllocator& _allocator = TAllocator())
+      : allocator(_allocator), layers(allocator), tree(allocator) {
+    Resize(nlayers);
+  }
+
+  const TAllocator& Allocator() const { return allocator; }
+
+  void Resize(unsigned nlayers) {
+    layers.clear();
+    layers.resize(nlayers, THeap(allocator));
+    size = 0;
+    for (tree_size = 1; tree_size < nlayers;) tree_size *= 2;
+    tree.assign(2 * tree_size, nlayers);
+  }
+
+  unsigned Layers() const { return unsigned(layers.size()); }
+  const THeap& Layer(unsigned l) const { return layers[l]; }
+
+  bool Empty() const { return size == 0; }
+  bool Empty(unsigned l) const { return layers[l].Empty(); }
+  // Total number of values in all layers.
+  size_t Size() const { return size; }
+
+  void Add(unsigned l, const TData& value) {
+    bool update = layers[l].Empty() || compare(value, layers[l].Top());
+    layers[l].Add(value);
+    ++size;
+    if (update) Update(l);
+  }
+
+  const TData& Top(unsigned l) const { return layers[l].Top(); }
+
+  void Pop(unsigned l) {
+    layers[l].Pop();
+    --size;
+    Update(l);
+  }
+
+  void Clear(unsigned l) {
+    if (layers[l].Empty()) return;
+    size -= layers[l].Size();
+    layers[l].Clear();
+    Update(l);
+  }
+
+  void Assign(unsigned l, THeap&& heap) {
+    size -= layers[l].Size();
+    layers[l] = std::move(heap);
+    size += layers[l].Size();
+    Update(l);
+  }
+
+  // Leftmost layer from [begin, Layers()) with the best top,
+  // Layers() if all of them are empty.
+  unsigned Best(unsigned begin = 0) const {
+    unsigned best = Layers();
+    for (unsigned l = begin + tree_size, r = 2 * tree_size; l < r;
+         l >>= 1, r >>= 1) {
+      if (l & 1) best = Better(best, tree[l++]);
+    }
+    return best;
+  }
+
+  // Leftmost non-empty layer from [begin, Layers()),
+  // Layers() if all of them are empty.
+  unsigned Next(unsigned begin = 0) const {
+    for (unsigned l = begin + tree_size, r = 2 * tree_size; l < r;
+         l >>= 1, r >>= 1) {
+      if (l & 1) {
+        if (tree[l] != Layers()) {
+          for (; l < tree_size;)
+            l = (tree[2 * l] != Layers()) ? 2 * l : 2 * l + 1;
+          return l - tree_size;
+        }
+        ++l;
+      }
+    }
+    return Layers();
+  }
+
+ protected:
+  unsigned Better(unsigned l1, unsigned l2) const {
+    if (l1 == Layers()) return l2;
+    if (l2 == Layers()) return l1;
+    return compare(layers[l2].Top(), layers[l1].Top()) ? l2 : l1;
+  }
+
+  void Update(unsigned l) {
+    unsigned node = l + tree_size;
+    tree[node] = layers[l].Empty() ? Layers() : l;
+    for (node >>= 1; node; node >>= 1)
+      tree[node] = Better(tree[2 * node], tree[2 * node + 1]);
+  }
+};
+}  // namespace ext
+}  // namespace heap
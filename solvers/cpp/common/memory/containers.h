@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/heap.h"
+#include "common/memory/counting_allocator.h"
+
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace memory {
+// Containers that report memory usage into Counter.
+template <class TKey, class TValue, class THash = std::hash<TKey>>
+using UnorderedMap =
+    std::unordered_map<TKey, TValue, THash, std::equal_to<TKey>,
+                       CountingAllocator<std::pair<const TKey, TValue>>>;
+
+template <class TValue>
+using HeapMinOnTop = heap::base::DHeap<4u, TValue, std::less<TValue>,
+                                       CountingAllocator<TValue>>;
+
+template <class TValue>
+using LayeredHeapMinOnTop = heap::ext::LayeredHeap<HeapMinOnTop<TValue>>;
+}  // namespace memory
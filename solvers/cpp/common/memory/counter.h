@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <algorithm>
+
+namespace memory {
+// Estimation of memory used by malloc for request of n bytes
+// (chunk header and 16 bytes alignment, glibc-like).
+inline size_t AllocationSize(size_t n) {
+  return std::max<size_t>(32, (n + 8 + 15) & ~size_t(15));
+}
+
+// Memory used by containers that allocate through CountingAllocator.
+// Not thread safe, expected to be owned by single search.
+class Counter {
+ protected:
+  size_t bytes = 0;
+  size_t peak = 0;
+
+ public:
+  size_t Bytes() const { return bytes; }
+  size_t Peak() const { return peak; }
+
+  void Allocate(size_t n) {
+    if (!n) return;
+    bytes += AllocationSize(n);
+    peak = std::max(peak, bytes);
+  }
+
+  void Deallocate(size_t n) {
+    if (n) bytes -= AllocationSize(n);
+  }
+};
+}  // namespace memory
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/memory/counter.h"
+
+#include <memory>
+
+namespace memory {
+// std::allocator that reports every allocation into Counter.
+// Counter should outlive all containers that use allocator.
+template <class T>
+class CountingAllocator {
+ public:
+  using value_type = T;
+
+  Counter* counter;
+
+ public:
+  explicit CountingAllocator(Counter* _counter) : counter(_counter) {}
+
+  template <class U>
+  CountingAllocator(const CountingAllocator<U>& r) : counter(r.counter) {}
+
+  T* allocate(size_t n) {
+    counter->Allocate(n * sizeof(T));
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* p, size_t n) {
+    counter->Deallocate(n * sizeof(T));
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  bool operator==(const CountingAllocator<U>& r) const {
+    return counter == r.counter;
+  }
+
+  template <class U>
+  bool operator!=(const CountingAllocator<U>& r) const {
+    return counter != r.counter;
+  }
+};
+}  // namespace memory
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <atomic>
+#include <fstream>
+
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+namespace memory {
+// Total physical memory of the machine in bytes.
+inline uint64_t PhysicalMemory() {
+  return uint64_t(sysconf(_SC_PHYS_PAGES)) * uint64_t(sysconf(_SC_PAGESIZE));
+}
+
+// Resident set size of the current process in bytes, 0 if unknown.
+inline uint64_t CurrentRSS() {
+#if defined(__APPLE__)
+  mach_task_basic_info info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+    return 0;
+  return info.resident_size;
+#else
+  std::ifstream f("/proc/self/statm");
+  uint64_t pages_total = 0, pages_resident = 0;
+  if (!(f >> pages_total >> pages_resident)) return 0;
+  return pages_resident * uint64_t(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+// Limit for RSS of the whole process, 0 - no limit.
+inline std::atomic<uint64_t>& ProcessLimit() {
+  static std::atomic<uint64_t> limit(0);
+  return limit;
+}
+
+inline void SetProcessLimit(uint64_t bytes) { ProcessLimit() = bytes; }
+
+// Real RSS is expensive to get, so it's checked on every 4096th call only.
+inline bool ProcessOverLimit() {
+  uint64_t limit = ProcessLimit();
+  if (!limit) return false;
+  thread_local unsigned calls = 0;
+  thread_local bool over = false;
+  if ((calls++ & 4095) == 0) over = (CurrentRSS() > limit);
+  return over;
+}
+}  // namespace memory
@@ -0,0 +1,259 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/solvers/metrics.h"
+#include "common/stats/registry.h"
+#include "common/string/utils/split.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace solvers {
+// Result of single solver run in benchmark.
+class BenchRecord {
+ public:
+  std::string solver;
+  std::string problem;
+  unsigned rep = 0;
+  double wall_time = 0;
+  bool correct = false;
+  int64_t score = 0;
+  Metrics metrics;
+
+  // Histograms are stored as count, mean and max.
+  void SetMetrics(const stats::Values& values) {
+    metrics.Clear();
+    for (auto& it : values.counters) metrics.Set(it.first, it.second);
+    for (auto& it : values.maxima) metrics.Set(it.first, it.second);
+    for (auto& it : values.histograms) {
+      metrics.Set(it.first + "_count", it.second.count);
+      metrics.Set(it.first + "_mean", it.second.Mean());
+      metrics.Set(it.first + "_max", it.second.max);
+    }
+  }
+
+  // Metrics with derived throughput and hit rates.
+  Metrics AllMetrics() const {
+    auto m = metrics;
+    if (m.Has("nodes_expanded") && (wall_time > 0))
+      m.Set("nodes_per_sec", m.Get("nodes_expanded") / wall_time);
+    if ((m.Get("perf_cycles") > 0) && m.Has("perf_instructions"))
+      m.Set("perf_ipc", m.Get("perf_instructions") / m.Get("perf_cycles"));
+    for (auto& it : metrics.Values()) {
+      const std::string suffix = "_lookups";
+      auto& name = it.first;
+      if ((name.size() <= suffix.size()) ||
+          (name.compare(name.size() - suffix.size(), suffix.size(), suffix) !=
+           0))
+        continue;
+      auto base = name.substr(0, name.size() - suffix.size());
+      if (it.second > 0)
+        m.Set(base + "_hit_rate", m.Get(base + "_hits") / it.second);
+    }
+    return m;
+  }
+};
+
+// Benchmark results, stored as CSV (can be used as baseline) or JSON.
+class BenchReport {
+ public:
+  std::vector<BenchRecord> records;
+
+ protected:
+  static std::string Format(double x) {
+    std::ostringstream ss;
+    ss << std::setprecision(12) << x;
+    return ss.str();
+  }
+
+  // Whole string must be a number.
+  template <class T>
+  static bool Parse(const std::string& s, T& x) {
+    auto end = s.data() + s.size();
+    auto r = std::from_chars(s.data(), end, x);
+    return (r.ec == std::errc()) && (r.ptr == end);
+  }
+
+  std::vector<std::string> MetricNames() const {
+    std::set<std::string> names;
+    for (auto& r : records) {
+      auto m = r.AllMetrics();
+      for (auto& it : m.Values()) names.insert(it.first);
+    }
+    return {names.begin(), names.end()};
+  }
+
+ public:
+  void WriteCSV(std::ostream& s) const {
+    auto names = MetricNames();
+    s << "solver,problem,rep,wall_time,correct,score";
+    for (auto& name : names) s << "," << name;
+    s << "\n";
+    for (auto& r : records) {
+      auto m = r.AllMetrics();
+      s << r.solver << "," << r.problem << "," << r.rep << ","
+        << Format(r.wall_time) << "," << r.correct << "," << r.score;
+      for (auto& name : names)
+        s << "," << (m.Has(name) ? Format(m.Get(name)) : "");
+      s << "\n";
+    }
+  }
+
+  void WriteJSON(std::ostream& s) const {
+    s << "[\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+      auto& r = records[i];
+      s << "  {\"solver\": \"" << r.solver << "\", \"problem\": \""
+        << r.problem << "\", \"rep\": " << r.rep
+        << ", \"wall_time\": " << Format(r.wall_time)
+        << ", \"correct\": " << (r.correct ? "true" : "false")
+        << ", \"score\": " << r.score << ", \"metrics\": {";
+      bool first = true;
+      auto m = r.AllMetrics();
+      for (auto& it : m.Values()) {
+        s << (first ? "" : ", ") << "\"" << it.first
+          << "\": " << Format(it.second);
+        first = false;
+      }
+      s << "}}" << ((i + 1 < records.size()) ? "," : "") << "\n";
+    }
+    s << "]\n";
+  }
+
+  // Format is selected by extension, ".json" or CSV otherwise.
+  bool Save(const std::string& filename) const {
+    std::ofstream f(filename);
+    if (!f.is_open()) return false;
+    auto ext = std::string(".json");
+    bool json = (filename.size() >= ext.size()) &&
+                (filename.compare(filename.size() - ext.size(), ext.size(),
+                                  ext) == 0);
+    if (json)
+      WriteJSON(f);
+    else
+      WriteCSV(f);
+    return f.good();
+  }
+
+  // Derived metrics are read as regular ones. Malformed rows are skipped
+  // with warning.
+  bool LoadCSV(const std::string& filename) {
+    records.clear();
+    std::ifstream f(filename);
+    if (!f.is_open()) return false;
+    std::string line;
+    if (!std::getline(f, line)) return false;
+    auto header = SplitAll(line, ",");
+    if ((header.size() < 6) || (header[0] != "solver")) return false;
+    for (unsigned line_number = 2; std::getline(f, line); ++line_number) {
+      if (line.empty()) continue;
+      auto v = SplitAll(line, ",");
+      BenchRecord r;
+      bool ok = (v.size() == header.size()) && Parse(v[2], r.rep) &&
+                Parse(v[3], r.wall_time) && Parse(v[5], r.score);
+      for (size_t i = 6; ok && (i < v.size()); ++i) {
+        double x = 0;
+        if (v[i].empty()) continue;
+        ok = Parse(v[i], x);
+        r.metrics.Set(header[i], x);
+      }
+      if (!ok) {
+        std::cerr << "Skipping malformed row " << line_number << " in "
+                  << filename << std::endl;
+        continue;
+      }
+      r.solver = v[0];
+      r.problem = v[1];
+      r.correct = (v[4] == "1");
+      records.push_back(r);
+    }
+    return true;
+  }
+
+ protected:
+  // (solver, problem)
+  using TKey = std::pair<std::string, std::string>;
+
+  class Summary {
+   public:
+    double wall_time = 0;
+    double nodes_per_sec = -1;
+    bool correct = false;
+    int64_t score = 0;
+  };
+
+  // Median over repetitions for times, best result for scores.
+  std::map<TKey, Summary> Summarize() const {
+    std::map<TKey, std::vector<const BenchRecord*>> groups;
+    for (auto& r : records) groups[{r.solver, r.problem}].push_back(&r);
+    std::map<TKey, Summary> output;
+    for (auto& g : groups) {
+      Summary s;
+      std::vector<double> vt, vn;
+      for (auto r : g.second) {
+        vt.push_back(r->wall_time);
+        auto m = r->AllMetrics();
+        if (m.Has("nodes_per_sec")) vn.push_back(m.Get("nodes_per_sec"));
+        if (r->correct && (!s.correct || (r->score < s.score))) {
+          s.correct = true;
+          s.score = r->score;
+        }
+      }
+      auto median = [](std::vector<double>& v) {
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        return v[v.size() / 2];
+      };
+      s.wall_time = median(vt);
+      if (!vn.empty()) s.nodes_per_sec = median(vn);
+      output[g.first] = s;
+    }
+    return output;
+  }
+
+ public:
+  // Prints and counts regressions against baseline: worse or incorrect
+  // result, wall time or throughput worse by more than tolerance (fraction).
+  // Wall times below min_time seconds are considered noise.
+  unsigned Compare(const BenchReport& baseline, double tolerance,
+                   double min_time = 0.05) const {
+    auto current = Summarize(), base = baseline.Summarize();
+    unsigned regressions = 0;
+    auto report = [&](const TKey& key, const std::string& what,
+                      const std::string& from, const std::string& to) {
+      std::cout << "REGRESSION\t" << key.first << "\t" << key.second << "\t"
+                << what << "\t" << from << " -> " << to << std::endl;
+      ++regressions;
+    };
+    for (auto& it : current) {
+      auto itb = base.find(it.first);
+      if (itb == base.end()) continue;
+      auto &c = it.second, &b = itb->second;
+      if (b.correct && (!c.correct || (c.score > b.score)))
+        report(it.first, "score", std::to_string(b.score),
+               c.correct ? std::to_string(c.score) : "incorrect");
+      if ((std::max(c.wall_time, b.wall_time) >= min_time) &&
+          (c.wall_time > b.wall_time * (1 + tolerance)))
+        report(it.first, "wall_time", Format(b.wall_time),
+               Format(c.wall_time));
+      if ((b.nodes_per_sec > 0) && (c.nodes_per_sec >= 0) &&
+          (c.wall_time >= min_time) &&
+          (c.nodes_per_sec < b.nodes_per_sec * (1 - tolerance)))
+        report(it.first, "nodes_per_sec", Format(b.nodes_per_sec),
+               Format(c.nodes_per_sec));
+    }
+    std::cout << "Compared " << current.size() << " runs, " << regressions
+              << " regressions." << std::endl;
+    return regressions;
+  }
+};
+}  // namespace solvers
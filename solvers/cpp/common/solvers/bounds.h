@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace solvers {
+// Best known lower bound and incumbent score for problem (lower score is
+// better).
+// Stored as text file "<lower_bound> <incumbent>".
+class Bounds {
+ public:
+  int64_t lower_bound = 0;
+  int64_t incumbent = -1;
+
+ public:
+  bool Known() const { return incumbent >= 0; }
+  // Incumbent can't be improved anymore.
+  bool Optimal() const { return Known() && (incumbent <= lower_bound); }
+  int64_t Gap() const { return Known() ? incumbent - lower_bound : -1; }
+
+  bool Load(const std::string& filename) {
+    std::ifstream f(filename);
+    if (!f.is_open()) return false;
+    return bool(f >> lower_bound >> incumbent);
+  }
+
+  void Save(const std::string& filename) const {
+    std::error_code ec;
+    std::filesystem::create_directories(
+        std::filesystem::path(filename).parent_path(), ec);
+    std::ofstream f(filename);
+    f << lower_bound << " " << incumbent << std::endl;
+  }
+
+  // Returns true if bounds were improved.
+  bool Update(int64_t new_lower_bound, int64_t new_incumbent) {
+    bool updated = false;
+    if (new_lower_bound > lower_bound) {
+      lower_bound = new_lower_bound;
+      updated = true;
+    }
+    if ((new_incumbent >= 0) && (!Known() || (new_incumbent < incumbent))) {
+      incumbent = new_incumbent;
+      updated = true;
+    }
+    return updated;
+  }
+};
+}  // namespace solvers
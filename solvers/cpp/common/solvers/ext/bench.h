@@ -0,0 +1,68 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/solvers/bench_report.h"
+#include "common/stats/perf_counters.h"
+#include "common/stats/registry.h"
+#include "common/timer.h"
+
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace solvers {
+namespace ext {
+// Runs every solver on every problem nrepetitions times in the current
+// thread, solutions are evaluated but not stored. With perf hardware counters
+// are recorded for Solve and sampled hot regions (if available).
+template <class TSolver>
+inline void Bench(const std::vector<typename TSolver::PSolver>& solvers,
+                  unsigned first_problem, unsigned last_problem,
+                  unsigned nrepetitions, BenchReport& report,
+                  bool perf = false) {
+  using TProblem = typename TSolver::TProblem;
+  using TSolution = typename TSolver::TSolution;
+  using TEvaluator = typename TSolver::TEvaluator;
+  if (perf && !stats::PerfCounters().Open())
+    std::cerr << "Hardware counters are not available." << std::endl;
+  for (unsigned i = first_problem; i <= last_problem; ++i) {
+    TProblem p;
+    if (!p.Load(std::to_string(i))) continue;
+    for (auto& psolver : solvers) {
+      for (unsigned rep = 0; rep < nrepetitions; ++rep) {
+        auto solver = psolver->Clone();
+        assert(solver);
+        // Stats are collected for benchmark even if they are disabled.
+        stats::Collector collector;
+        TSolution s;
+        Timer t;
+        {
+          stats::Attach attach(collector);
+          std::optional<stats::PerfScope> perf_scope;
+          if (perf) perf_scope.emplace();
+          t.Start();
+          if (perf_scope) perf_scope->Start();
+          s = solver->Solve(p);
+          if (perf_scope) perf_scope->Stop();
+          t.Stop();
+        }
+        auto r = TEvaluator::Apply(p, s);
+        BenchRecord record;
+        record.solver = solver->Name();
+        record.problem = p.Id();
+        record.rep = rep;
+        record.wall_time = t.GetMicroseconds() * 1e-6;
+        record.correct = r.correct;
+        record.score = r.score;
+        record.SetMetrics(collector.Snapshot());
+        report.records.push_back(record);
+        std::cout << "Bench\t" << record.solver << "\t" << record.problem
+                  << "\t" << rep << "\t" << record.wall_time << "\t"
+                  << record.correct << "\t" << record.score << std::endl;
+      }
+    }
+  }
+}
+}  // namespace ext
+}  // namespace solvers
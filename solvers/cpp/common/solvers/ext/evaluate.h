@@ -1,40 +1,87 @@
 #pragma once
 
+#include "common/files/mapped_file.h"
+#include "common/solvers/score_index.h"
+
 #include <string>
 
 namespace solvers {
 namespace ext {
+// Evaluates stored solution using score index, solution is validated only if
+// file content was changed since last evaluation. Problem p is loaded only if
+// validation is required, if p is null.
+// Returns (false, -1) if problem can't be loaded and (false, -2) if solution
+// doesn't exist. nthreads is passed to TEvaluator::Apply.
+template <class TEvaluator, class TProblem, class TSolution>
+inline typename TEvaluator::Result EvaluateStored(
+    const std::string& id, const std::string& solver_name,
+    const TProblem* p = nullptr, unsigned nthreads = 0) {
+  using TResult = typename TEvaluator::Result;
+  auto filename = TSolution::StoredFileName(id, solver_name);
+  auto index_filename = TSolution::IndexFileName(solver_name);
+  ScoreIndex::Entry e, e_old;
+  if (!ScoreIndex::Stat(filename, e.length, e.mtime) || (e.length == 0))
+    return TResult(false, -2);
+  bool known = ScoreIndex::Find(index_filename, id, e_old);
+  if (known && (e_old.length == e.length) && (e_old.mtime == e.mtime))
+    return TResult(e_old.correct, e_old.score);
+  // File was touched, check if content is the same.
+  files::MappedFile content(filename);
+  e.length = content.Size();
+  e.hash = ScoreIndex::Hash(content.View());
+  if (known && (e_old.length == e.length) && (e_old.hash == e.hash)) {
+    e.correct = e_old.correct;
+    e.score = e_old.score;
+  } else {
+    TProblem pl;
+    if (!p) {
+      if (!pl.Load(id)) return TResult(false, -1);
+      p = &pl;
+    }
+    TSolution s;
+    if (!s.LoadView(id, solver_name)) return TResult(false, -2);
+    auto r = TEvaluator::Apply(*p, s, nthreads);
+    e.correct = r.correct;
+    e.score = r.score;
+  }
+  ScoreIndex::Update(index_filename, id, e);
+  return TResult(e.correct, e.score);
+}
+
+// Saves solution with already known evaluation result and updates score
+// index.
+template <class TSolution, class TResult>
+inline void SaveStored(const TSolution& s, const std::string& solver_name,
+                       const TResult& r) {
+  s.Save(solver_name);
+  auto filename = TSolution::StoredFileName(s.GetId(), solver_name);
+  ScoreIndex::Entry e;
+  if (!ScoreIndex::Stat(filename, e.length, e.mtime)) return;
+  files::MappedFile content(filename);
+  e.length = content.Size();
+  e.hash = ScoreIndex::Hash(content.View());
+  e.correct = r.correct;
+  e.score = r.score;
+  ScoreIndex::Update(TSolution::IndexFileName(solver_name), s.GetId(), e);
+}
+
 template <class TEvaluator, class TProblem, class TSolution>
 inline typename TEvaluator::Result Evaluate(const std::string& id,
                                             const std::string& solver_name) {
-  using TResult = typename TEvaluator::Result;
-  TProblem p;
-  if (!p.Load(id)) return TResult(false, -1);
-  TSolution s;
-  if (!s.Load(id, solver_name)) return TResult(false, -2);
-  return TEvaluator::Apply(p, s);
+  return EvaluateStored<TEvaluator, TProblem, TSolution>(id, solver_name);
 }
 
 template <class TEvaluator, class TProblem, class TSolution>
 inline bool UpdateBest(const std::string& id, const std::string& solver_name,
                        const std::string& best_name) {
-  TProblem p;
-  if (!p.Load(id)) return false;
-  TSolution s;
-  if (!s.Load(id, solver_name)) return false;
-  auto r = TEvaluator::Apply(p, s);
+  auto r = EvaluateStored<TEvaluator, TProblem, TSolution>(id, solver_name);
   if (!r.correct) return false;
-  TSolution sbest;
-  if (!sbest.Load(id, best_name)) {
-    s.Save(best_name);
-    return true;
-  }
-  auto rbest = TEvaluator::Apply(p, sbest);
-  if (TEvaluator::Compare(r, rbest)) {
-    s.Save(best_name);
-    return true;
-  }
-  return false;
+  auto rbest = EvaluateStored<TEvaluator, TProblem, TSolution>(id, best_name);
+  if (!TEvaluator::Compare(r, rbest)) return false;
+  TSolution s;
+  if (!s.LoadView(id, solver_name)) return false;
+  SaveStored(s, best_name, r);
+  return true;
 }
 }  // namespace ext
 }  // namespace solvers
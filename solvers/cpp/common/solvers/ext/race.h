@@ -0,0 +1,110 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/solvers/bounds.h"
+#include "common/solvers/ext/evaluate.h"
+#include "common/solvers/ext/run_one.h"
+#include "common/solvers/shared_bounds.h"
+#include "common/stats/registry.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace solvers {
+namespace ext {
+// Runs all solvers from portfolio on the same problem at once, one thread per
+// solver. Solvers share incumbent score (to prune against it) and stop when
+// one of them proves optimality, time limit is own for every solver.
+// Solutions are stored like in RunOne.
+template <class TSolver>
+inline void RaceOne(const std::vector<typename TSolver::PSolver>& portfolio,
+                    const std::string& problem_id,
+                    stats::Collector* batch = nullptr) {
+  using TProblem = typename TSolver::TProblem;
+  using TSolution = typename TSolver::TSolution;
+  using TEvaluator = typename TSolver::TEvaluator;
+  TProblem p;
+  if (!p.Load(problem_id)) {
+    assert(false);
+    return;
+  }
+  auto bounds_filename = TSolution::BoundsFileName(problem_id);
+  Bounds bounds;
+  bounds.Load(bounds_filename);
+  auto rbest =
+      EvaluateStored<TEvaluator, TProblem, TSolution>(problem_id, "best", &p);
+  if (rbest.correct && (rbest.score <= bounds.lower_bound)) {
+    std::cout << "Best solution for problem " << problem_id
+              << " is optimal, skipping." << std::endl;
+    return;
+  }
+  auto shared = std::make_shared<SharedBounds>(
+      bounds.lower_bound, rbest.correct ? rbest.score : -1);
+
+  std::mutex m;
+  stats::Collector collector;
+  int64_t new_lower_bound = 0;
+  std::string winner;
+  {
+    ThreadPool tp(portfolio.size());
+    for (auto& psolver : portfolio) {
+      auto t = std::make_shared<std::packaged_task<void()>>([&, psolver]() {
+        auto solver = psolver->Clone();
+        assert(solver);
+        solver->SetSharedBounds(shared);
+        auto s = SolveWithStats(*solver, p, collector);
+        // Other solvers are still running, validate in the same thread.
+        auto r = TEvaluator::Apply(p, s, 1);
+        if (r.correct) shared->UpdateIncumbent(r.score);
+        shared->UpdateLowerBound(solver->LowerBound());
+
+        std::lock_guard<std::mutex> lock(m);
+        auto solver_name = solver->Name();
+        new_lower_bound = std::max(new_lower_bound, solver->LowerBound());
+        if (r.correct && !solver->SkipSolutionWrite()) {
+          auto rcache = EvaluateStored<TEvaluator, TProblem, TSolution>(
+              problem_id, solver_name, &p, 1);
+          if (TEvaluator::Compare(r, rcache)) SaveStored(s, solver_name, r);
+        }
+        if (r.correct && !solver->SkipBest() &&
+            TEvaluator::Compare(r, rbest)) {
+          SaveStored(s, "best", r);
+          rbest = r;
+          winner = solver_name;
+        }
+      });
+      tp.EnqueueTask(std::move(t));
+    }
+  }
+  std::cout << "Race for problem " << problem_id << ": "
+            << (winner.empty() ? "no improvements"
+                               : "new best solution from " + winner)
+            << ", best = " << (rbest.correct ? rbest.score : -1)
+            << ", lower bound = " << shared->LowerBound() << std::endl;
+  auto values = collector.Snapshot();
+  stats::Print("Stats for problem " + problem_id, values);
+  if (batch) batch->Merge(values);
+  if (bounds.Update(new_lower_bound, rbest.correct ? rbest.score : -1)) {
+    if (bounds.Optimal()) {
+      std::cout << "Problem " << problem_id
+                << " is solved optimally: " << bounds.incumbent << std::endl;
+    }
+    bounds.Save(bounds_filename);
+  }
+}
+
+template <class TSolver>
+inline void RaceN(const std::vector<typename TSolver::PSolver>& portfolio,
+                  unsigned first_problem, unsigned last_problem) {
+  stats::Collector batch;
+  for (unsigned i = first_problem; i <= last_problem; ++i)
+    RaceOne<TSolver>(portfolio, std::to_string(i), &batch);
+  stats::Print("Stats for all problems", batch.Snapshot());
+}
+}  // namespace ext
+}  // namespace solvers
@@ -2,6 +2,7 @@
 
 #include "common/solvers/ext/run_one.h"
 #include "common/solvers/ext/run_one_thread_safe.h"
+#include "common/stats/registry.h"
 #include "common/thread_pool.h"
 
 #include <string>
@@ -11,8 +12,10 @@ namespace ext {
 // Single thread version
 template <class TSolver>
 inline void RunN(TSolver& s, unsigned first_problem, unsigned last_problem) {
+  stats::Collector batch;
   for (unsigned i = first_problem; i <= last_problem; ++i)
-    RunOne<TSolver>(s, std::to_string(i));
+    RunOne<TSolver>(s, std::to_string(i), &batch);
+  stats::Print("Stats for all problems", batch.Snapshot());
 }
 
 // Multi threads version
@@ -20,15 +23,19 @@ template <class TSolver>
 inline void RunNMT(TSolver& s, unsigned first_problem, unsigned last_problem,
                    unsigned nthreads) {
   auto psolver = s.Clone();
+  stats::Collector batch;
   {
     // ThreadPool desctructor should be called before destructor for psolver.
     ThreadPool tp(nthreads);
     for (unsigned i = first_problem; i <= last_problem; ++i) {
       auto t = std::make_shared<std::packaged_task<void()>>(
-          [&, i]() { RunOneThreadSafe<TSolver>(psolver, std::to_string(i)); });
+          [&, i]() {
+            RunOneThreadSafe<TSolver>(psolver, std::to_string(i), &batch);
+          });
       tp.EnqueueTask(std::move(t));
     }
   }
+  stats::Print("Stats for all problems", batch.Snapshot());
 }
 }  // namespace ext
 }  // namespace solvers
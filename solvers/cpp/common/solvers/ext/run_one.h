@@ -1,50 +1,108 @@
 #pragma once
 
 #include "common/base.h"
+#include "common/solvers/bounds.h"
+#include "common/solvers/ext/evaluate.h"
+#include "common/stats/registry.h"
+#include "common/stats/trace.h"
+#include "common/timer.h"
 
+#include <iostream>
+#include <optional>
 #include <string>
 
 namespace solvers {
 namespace ext {
+// Solves problem with stats of solver collected into collector if stats are
+// enabled.
 template <class TSolver>
-inline void RunOne(TSolver& solver, const std::string& problem_id) {
+inline typename TSolver::TSolution SolveWithStats(
+    TSolver& solver, const typename TSolver::TProblem& p,
+    stats::Collector& collector) {
+  std::optional<stats::Attach> attach;
+  if (stats::Enabled()) attach.emplace(collector);
+  stats::Span span("Solve", "solver",
+                   {{"problem", p.Id()}, {"solver", solver.Name()}});
+  Timer t;
+  auto s = solver.Solve(p);
+  stats::Record("solve_ms", t.GetMilliseconds());
+  return s;
+}
+
+// Stats of solver are printed per problem and merged into batch (if not
+// null). Solutions are validated with nthreads threads (0 -- all hardware
+// threads).
+template <class TSolver>
+inline void RunOne(TSolver& solver, const std::string& problem_id,
+                   stats::Collector* batch = nullptr, unsigned nthreads = 0) {
   using TProblem = typename TSolver::TProblem;
   using TSolution = typename TSolver::TSolution;
   using TEvaluator = typename TSolver::TEvaluator;
+  stats::Span span("RunOne", "run",
+                   {{"problem", problem_id}, {"solver", solver.Name()}});
   TProblem p;
   if (!p.Load(problem_id)) {
     assert(false);
     return;
   }
+  auto bounds_filename = TSolution::BoundsFileName(problem_id);
+  Bounds bounds;
+  bounds.Load(bounds_filename);
+  // Stored solutions are validated only if they were changed.
+  auto rbest =
+      EvaluateStored<TEvaluator, TProblem, TSolution>(problem_id, "best", &p,
+                                                      nthreads);
+  if (rbest.correct && (rbest.score <= bounds.lower_bound)) {
+    std::cout << "Best solution for problem " << problem_id
+              << " is optimal, skipping." << std::endl;
+    return;
+  }
   auto solver_name = solver.Name();
   TSolution s;
   if (!solver.SkipSolutionRead()) {
-    s.Load(problem_id, solver_name);
+    s.LoadView(problem_id, solver_name);
   }
   bool new_solution = false;
   if (s.Empty()) {
-    s = solver.Solve(p);
+    stats::Collector collector;
+    s = SolveWithStats(solver, p, collector);
     new_solution = true;
+    auto values = collector.Snapshot();
+    stats::Print("Stats for problem " + problem_id + " (" + solver_name + ")",
+                 values);
+    if (batch) batch->Merge(values);
   }
-  auto r = TEvaluator::Apply(p, s);
-  if (!r.correct) return;
-  if (new_solution && !solver.SkipSolutionWrite()) {
-    TSolution scache;
-    scache.Load(problem_id, solver_name);
-    auto rcache = TEvaluator::Apply(p, scache);
+  auto r = new_solution ? TEvaluator::Apply(p, s, nthreads)
+                        : EvaluateStored<TEvaluator, TProblem, TSolution>(
+                              problem_id, solver_name, &p, nthreads);
+  if (r.correct && new_solution && !solver.SkipSolutionWrite()) {
+    auto rcache = EvaluateStored<TEvaluator, TProblem, TSolution>(
+        problem_id, solver_name, &p, nthreads);
     if (TEvaluator::Compare(r, rcache)) {
       std::cout << "New solution for problem: " << problem_id << std::endl;
-      s.Save(solver_name);
+      stats::Instant("new_solution", "run",
+                     {{"problem", problem_id},
+                      {"score", std::to_string(r.score)}});
+      SaveStored(s, solver_name, r);
     }
   }
-  if (!solver.SkipBest()) {
-    TSolution sbest;
-    sbest.Load(problem_id, "best");
-    auto rbest = TEvaluator::Apply(p, sbest);
+  if (r.correct && !solver.SkipBest()) {
     if (TEvaluator::Compare(r, rbest)) {
       std::cout << "New best solution for problem: " << problem_id << std::endl;
-      s.Save("best");
+      stats::Instant("new_best", "run",
+                     {{"problem", problem_id},
+                      {"score", std::to_string(r.score)}});
+      SaveStored(s, "best", r);
+      rbest = r;
+    }
+  }
+  if (bounds.Update(new_solution ? solver.LowerBound() : 0,
+                    rbest.correct ? rbest.score : -1)) {
+    if (bounds.Optimal()) {
+      std::cout << "Problem " << problem_id
+                << " is solved optimally: " << bounds.incumbent << std::endl;
     }
+    bounds.Save(bounds_filename);
   }
 }
 }  // namespace ext
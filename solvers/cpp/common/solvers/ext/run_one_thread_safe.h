@@ -2,18 +2,21 @@
 
 #include "common/base.h"
 #include "common/solvers/ext/run_one.h"
+#include "common/stats/registry.h"
 
 #include <string>
 
 namespace solvers {
 namespace ext {
+// Called from pool workers, so solutions are validated in the same thread.
 template <class TSolver>
 inline void RunOneThreadSafe(const typename TSolver::PSolver& psolver,
-                             const std::string& problem_id) {
+                             const std::string& problem_id,
+                             stats::Collector* batch = nullptr) {
   assert(psolver);
   auto ptemp = psolver->Clone();
   assert(ptemp);
-  RunOne<TSolver>(*ptemp, problem_id);
+  RunOne<TSolver>(*ptemp, problem_id, batch, 1);
 }
 }  // namespace ext
 }  // namespace solvers
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/solvers/bounds.h"
+#include "common/solvers/ext/evaluate.h"
+#include "common/solvers/param_space.h"
+#include "common/thread_pool.h"
+#include "common/timer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace solvers {
+namespace ext {
+// Creates solver for parameters and time limit (seconds).
+template <class TSolver>
+using SweepFactory = std::function<typename TSolver::PSolver(
+    const Params& params, unsigned max_time_in_seconds)>;
+
+// Best configuration for every problem over all evaluations of sweep.
+template <class TSolver>
+class SweepWinners {
+ public:
+  using TSolution = typename TSolver::TSolution;
+  using TResult = typename TSolver::TEvaluator::Result;
+
+  class Winner {
+   public:
+    Params params;
+    size_t config_index = 0;
+    unsigned max_time_in_seconds = 0;
+    TResult result;
+    TSolution solution;
+  };
+
+  std::map<std::string, Winner> winners;
+
+  bool Save(const std::string& filename) const {
+    std::ofstream f(filename);
+    if (!f.is_open()) return false;
+    f << "problem,correct,score,time,params\n";
+    for (auto& it : winners) {
+      auto& w = it.second;
+      f << it.first << "," << w.result.correct << "," << w.result.score << ","
+        << w.max_time_in_seconds << ",\"" << ParamsToString(w.params)
+        << "\"\n";
+    }
+    return f.good();
+  }
+};
+
+// Evaluates every configuration on every problem on the pool, returns
+// results[config][problem]. Winners are updated with better solutions.
+template <class TSolver>
+inline std::vector<std::vector<typename TSolver::TEvaluator::Result>>
+SweepRound(const SweepFactory<TSolver>& factory,
+           const std::vector<Params>& configs,
+           const std::vector<typename TSolver::TProblem>& problems,
+           unsigned max_time_in_seconds, unsigned nthreads,
+           SweepWinners<TSolver>& winners) {
+  using TEvaluator = typename TSolver::TEvaluator;
+  std::vector<std::vector<typename TEvaluator::Result>> results(
+      configs.size(),
+      std::vector<typename TEvaluator::Result>(problems.size()));
+  std::mutex m;
+  {
+    ThreadPool tp(std::max(nthreads, 1u));
+    for (size_t i = 0; i < configs.size(); ++i) {
+      for (size_t j = 0; j < problems.size(); ++j) {
+        auto t = std::make_shared<std::packaged_task<void()>>([&, i, j]() {
+          auto solver = factory(configs[i], max_time_in_seconds);
+          assert(solver);
+          auto& p = problems[j];
+          auto s = solver->Solve(p);
+          // Pool is busy, validate in the same thread.
+          auto r = TEvaluator::Apply(p, s, 1);
+          std::lock_guard<std::mutex> lock(m);
+          results[i][j] = r;
+          auto it = winners.winners.find(p.Id());
+          // Ties in the same round go to the first configuration, so result
+          // doesn't depend on order of completion.
+          if ((it == winners.winners.end()) ||
+              TEvaluator::Compare(r, it->second.result) ||
+              (!TEvaluator::Compare(it->second.result, r) &&
+               (it->second.max_time_in_seconds == max_time_in_seconds) &&
+               (i < it->second.config_index))) {
+            auto& w = winners.winners[p.Id()];
+            w.params = configs[i];
+            w.config_index = i;
+            w.max_time_in_seconds = max_time_in_seconds;
+            w.result = r;
+            w.solution = s;
+          }
+        });
+        tp.EnqueueTask(std::move(t));
+      }
+    }
+  }
+  return results;
+}
+
+// Quality of configuration over problems, sum of best_score / score (1 for
+// the best configuration on problem, 0 for incorrect solution).
+template <class TResult>
+inline std::vector<double> SweepQuality(
+    const std::vector<std::vector<TResult>>& results) {
+  std::vector<double> quality(results.size(), 0.);
+  if (results.empty()) return quality;
+  for (size_t j = 0; j < results[0].size(); ++j) {
+    int64_t best = -1;
+    for (auto& r : results) {
+      if (r[j].correct && ((best < 0) || (r[j].score < best)))
+        best = r[j].score;
+    }
+    for (size_t i = 0; i < results.size(); ++i) {
+      auto& r = results[i][j];
+      if (r.correct)
+        quality[i] += (r.score > 0) ? double(best) / r.score : 1.;
+    }
+  }
+  return quality;
+}
+
+// Runs sweep over configurations (grid or random sample of parameter
+// space). With halving only better half of configurations (by quality)
+// survives every round and time limit is doubled, last round uses
+// max_time_in_seconds. Best solution for every problem is stored like in
+// RunOne, winning parameters are saved to output (CSV).
+template <class TSolver>
+inline void Sweep(const SweepFactory<TSolver>& factory,
+                  const std::string& solver_name, std::vector<Params> configs,
+                  unsigned first_problem, unsigned last_problem,
+                  unsigned max_time_in_seconds, unsigned nthreads, bool halving,
+                  const std::string& output) {
+  using TProblem = typename TSolver::TProblem;
+  using TSolution = typename TSolver::TSolution;
+  using TEvaluator = typename TSolver::TEvaluator;
+  std::vector<TProblem> problems;
+  for (unsigned i = first_problem; i <= last_problem; ++i) {
+    TProblem p;
+    if (p.Load(std::to_string(i))) problems.push_back(p);
+  }
+  if (configs.empty() || problems.empty()) return;
+
+  Timer t;
+  SweepWinners<TSolver> winners;
+  unsigned rounds = 0;
+  if (halving) {
+    for (; (size_t(1) << rounds) < configs.size();) ++rounds;
+  }
+  for (unsigned round = 0; round <= rounds; ++round) {
+    unsigned round_time =
+        std::max(max_time_in_seconds >> (rounds - round), 1u);
+    auto results = SweepRound<TSolver>(factory, configs, problems, round_time,
+                                       nthreads, winners);
+    auto quality = SweepQuality(results);
+    std::vector<size_t> order(configs.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+      return quality[l] > quality[r];
+    });
+    std::cout << "Sweep round " << round << " (" << configs.size()
+              << " configurations, time limit " << round_time << "):\n";
+    for (auto i : order)
+      std::cout << "\t" << ParamsToString(configs[i]) << "\tquality = "
+                << quality[i] << "\n";
+    std::cout << std::flush;
+    if (round == rounds) break;
+    std::vector<Params> survivors;
+    for (size_t k = 0; k < (configs.size() + 1) / 2; ++k)
+      survivors.push_back(configs[order[k]]);
+    configs.swap(survivors);
+  }
+  std::cout << "Sweep finished in " << t.GetSeconds() << " seconds."
+            << std::endl;
+
+  for (auto& it : winners.winners) {
+    auto& w = it.second;
+    auto& problem_id = it.first;
+    std::cout << "Problem " << problem_id << ": "
+              << (w.result.correct ? std::to_string(w.result.score)
+                                   : "incorrect")
+              << " with " << ParamsToString(w.params) << std::endl;
+    if (!w.result.correct) continue;
+    auto rcache = EvaluateStored<TEvaluator, TProblem, TSolution>(
+        problem_id, solver_name);
+    if (TEvaluator::Compare(w.result, rcache))
+      SaveStored(w.solution, solver_name, w.result);
+    auto rbest =
+        EvaluateStored<TEvaluator, TProblem, TSolution>(problem_id, "best");
+    if (TEvaluator::Compare(w.result, rbest)) {
+      std::cout << "New best solution for problem: " << problem_id
+                << std::endl;
+      SaveStored(w.solution, "best", w.result);
+      auto bounds_filename = TSolution::BoundsFileName(problem_id);
+      Bounds bounds;
+      bounds.Load(bounds_filename);
+      if (bounds.Update(0, w.result.score)) bounds.Save(bounds_filename);
+    }
+  }
+  if (!output.empty() && !winners.Save(output))
+    std::cerr << "Failed to save " << output << std::endl;
+}
+}  // namespace ext
+}  // namespace solvers
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+namespace solvers {
+// Named measurements of solver work (nodes expanded, heap operations, cache
+// hits, ...) used by benchmarks.
+// Pairs "<name>_hits" and "<name>_lookups" are reported as hit rates.
+class Metrics {
+ protected:
+  std::map<std::string, double> values;
+
+ public:
+  bool Empty() const { return values.empty(); }
+  void Clear() { values.clear(); }
+
+  const std::map<std::string, double>& Values() const { return values; }
+
+  bool Has(const std::string& name) const {
+    return values.find(name) != values.end();
+  }
+
+  double Get(const std::string& name) const {
+    auto it = values.find(name);
+    return (it == values.end()) ? 0. : it->second;
+  }
+
+  void Set(const std::string& name, double value) { values[name] = value; }
+  void Add(const std::string& name, double value) { values[name] += value; }
+
+  void Max(const std::string& name, double value) {
+    auto it = values.find(name);
+    if (it == values.end())
+      values[name] = value;
+    else
+      it->second = std::max(it->second, value);
+  }
+};
+}  // namespace solvers
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/string/utils/split.h"
+
+#include <algorithm>
+#include <charconv>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace solvers {
+// Integer parameters of solver by name.
+using Params = std::map<std::string, int>;
+
+inline std::string ParamsToString(const Params& params) {
+  std::string s;
+  for (auto& it : params)
+    s += (s.empty() ? "" : ",") + it.first + "=" + std::to_string(it.second);
+  return s;
+}
+
+// Cartesian product of values for every parameter. Configurations are
+// numbered in mixed radix, last parameter changes fastest.
+class ParamSpace {
+ protected:
+  std::vector<std::pair<std::string, std::vector<int>>> dims;
+
+  // Whole string should be an integer.
+  static bool ParseInt(const std::string& s, int& value) {
+    auto end = s.data() + s.size();
+    auto r = std::from_chars(s.data(), end, value);
+    return (r.ec == std::errc()) && (r.ptr == end);
+  }
+
+ public:
+  void Add(const std::string& name, const std::vector<int>& values) {
+    dims.push_back({name, values});
+  }
+
+  bool Empty() const { return dims.empty(); }
+
+  // Format: "name=v1,v2,first:last[:step];name2=...".
+  bool Parse(const std::string& spec) {
+    dims.clear();
+    for (auto& sdim : Split(spec, ";")) {
+      auto v = SplitAll(sdim, "=");
+      if ((v.size() != 2) || v[0].empty()) return false;
+      std::vector<int> values;
+      for (auto& item : Split(v[1], ",")) {
+        auto r = SplitAll(item, ":");
+        if ((r.size() < 1) || (r.size() > 3)) return false;
+        int first = 0, last = 0, step = 1;
+        if (!ParseInt(r[0], first)) return false;
+        last = first;
+        if ((r.size() > 1) && !ParseInt(r[1], last)) return false;
+        if ((r.size() > 2) && !ParseInt(r[2], step)) return false;
+        if (step <= 0) return false;
+        // 64-bit counter, so last close to INT_MAX doesn't overflow.
+        for (int64_t x = first; x <= last; x += step) values.push_back(int(x));
+      }
+      if (values.empty()) return false;
+      Add(v[0], values);
+    }
+    return !dims.empty();
+  }
+
+  size_t Size() const {
+    size_t size = dims.empty() ? 0 : 1;
+    for (auto& d : dims) size *= d.second.size();
+    return size;
+  }
+
+  Params At(size_t index) const {
+    Params params;
+    for (auto it = dims.rbegin(); it != dims.rend(); ++it) {
+      params[it->first] = it->second[index % it->second.size()];
+      index /= it->second.size();
+    }
+    return params;
+  }
+
+  std::vector<Params> Grid() const {
+    std::vector<Params> output;
+    for (size_t i = 0; i < Size(); ++i) output.push_back(At(i));
+    return output;
+  }
+
+  // n distinct configurations (whole grid if it is not larger).
+  std::vector<Params> Random(size_t n, uint64_t seed) const {
+    auto size = Size();
+    if (n >= size) return Grid();
+    std::mt19937_64 rng(seed);
+    std::vector<size_t> indices;
+    if (size <= 4 * n) {
+      for (size_t i = 0; i < size; ++i) indices.push_back(i);
+      std::shuffle(indices.begin(), indices.end(), rng);
+      indices.resize(n);
+    } else {
+      std::uniform_int_distribution<size_t> d(0, size - 1);
+      for (; indices.size() < n;) {
+        auto i = d(rng);
+        if (std::find(indices.begin(), indices.end(), i) == indices.end())
+          indices.push_back(i);
+      }
+    }
+    std::sort(indices.begin(), indices.end());
+    std::vector<Params> output;
+    for (auto i : indices) output.push_back(At(i));
+    return output;
+  }
+};
+}  // namespace solvers
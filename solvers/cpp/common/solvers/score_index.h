@@ -0,0 +1,140 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+namespace solvers {
+// Evaluation results of stored solutions of one solver, so unchanged
+// solutions are not validated again.
+// Stored as text file, number of entries followed by one line per problem:
+//   "<id> <correct> <score> <length> <content_hash> <mtime>".
+// Index is only a cache: entry is trusted if file size and mtime match,
+// otherwise content hash is checked, otherwise solution is re-evaluated.
+// Index that doesn't match its entry count is dropped, so all solutions are
+// evaluated again.
+class ScoreIndex {
+ public:
+  class Entry {
+   public:
+    bool correct = false;
+    int64_t score = 0;
+    uint64_t length = 0;
+    uint64_t hash = 0;
+    int64_t mtime = 0;
+  };
+
+ protected:
+  std::map<std::string, Entry> entries;
+
+  // Serializes read-modify-write of index files inside process, between
+  // processes files are replaced atomically.
+  static std::mutex& Mutex() {
+    static std::mutex m;
+    return m;
+  }
+
+ public:
+  static uint64_t Hash(std::string_view content) {
+    return std::hash<std::string_view>{}(content);
+  }
+
+  // Size and modification time of file, false if it doesn't exist.
+  static bool Stat(const std::string& filename, uint64_t& length,
+                   int64_t& mtime) {
+    std::error_code ec;
+    length = std::filesystem::file_size(filename, ec);
+    if (ec) return false;
+    auto t = std::filesystem::last_write_time(filename, ec);
+    if (ec) return false;
+    mtime = t.time_since_epoch().count();
+    return true;
+  }
+
+  // Returns false (index is empty) if file is missing or corrupted.
+  bool Load(const std::string& filename) {
+    entries.clear();
+    std::ifstream f(filename);
+    if (!f.is_open()) return false;
+    size_t n = 0;
+    if (!(f >> n)) return false;
+    std::string id;
+    Entry e;
+    size_t lines = 0;
+    for (; f >> id >> e.correct >> e.score >> e.length >> e.hash >> e.mtime;) {
+      entries[id] = e;
+      ++lines;
+    }
+    if (!f.eof() || (lines != n) || (entries.size() != n)) {
+      entries.clear();
+      return false;
+    }
+    return true;
+  }
+
+  bool Save(const std::string& filename) const {
+    std::error_code ec;
+    std::filesystem::create_directories(
+        std::filesystem::path(filename).parent_path(), ec);
+    // Unique per process and call, other writers can't overwrite it before
+    // rename.
+    static std::atomic<unsigned> counter(0);
+    auto tmp = filename + ".tmp" + std::to_string(getpid()) + "." +
+               std::to_string(counter++);
+    {
+      std::ofstream f(tmp);
+      if (!f.is_open()) return false;
+      f << entries.size() << "\n";
+      for (auto& it : entries) {
+        auto& e = it.second;
+        f << it.first << " " << e.correct << " " << e.score << " " << e.length
+          << " " << e.hash << " " << e.mtime << "\n";
+      }
+      f.close();
+      if (!f) {
+        std::remove(tmp.c_str());
+        return false;
+      }
+    }
+    std::filesystem::rename(tmp, filename, ec);
+    if (ec) std::remove(tmp.c_str());
+    return !ec;
+  }
+
+  bool Find(const std::string& id, Entry& e) const {
+    auto it = entries.find(id);
+    if (it == entries.end()) return false;
+    e = it->second;
+    return true;
+  }
+
+  void Set(const std::string& id, const Entry& e) { entries[id] = e; }
+
+  // Thread safe versions that work with file directly.
+  static bool Find(const std::string& filename, const std::string& id,
+                   Entry& e) {
+    std::lock_guard<std::mutex> lock(Mutex());
+    ScoreIndex index;
+    return index.Load(filename) && index.Find(id, e);
+  }
+
+  static void Update(const std::string& filename, const std::string& id,
+                     const Entry& e) {
+    std::lock_guard<std::mutex> lock(Mutex());
+    ScoreIndex index;
+    index.Load(filename);
+    index.Set(id, e);
+    index.Save(filename);
+  }
+};
+}  // namespace solvers
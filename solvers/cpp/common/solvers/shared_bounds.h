@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <atomic>
+
+namespace solvers {
+// Bounds for one problem shared by solvers running on it at the same time
+// (lower score is better). Race is stopped once incumbent is proven optimal.
+class SharedBounds {
+ protected:
+  std::atomic<int64_t> lower_bound;
+  std::atomic<int64_t> incumbent;
+  std::atomic<bool> stopped;
+
+ public:
+  explicit SharedBounds(int64_t _lower_bound = 0, int64_t _incumbent = -1)
+      : lower_bound(_lower_bound), incumbent(_incumbent), stopped(false) {
+    CheckOptimal();
+  }
+
+  int64_t LowerBound() const { return lower_bound.load(); }
+  // -1 if unknown.
+  int64_t Incumbent() const { return incumbent.load(); }
+  bool Stopped() const { return stopped.load(std::memory_order_relaxed); }
+
+  void Stop() { stopped = true; }
+
+  void UpdateIncumbent(int64_t score) {
+    if (score < 0) return;
+    auto current = incumbent.load();
+    for (; ((current < 0) || (score < current)) &&
+           !incumbent.compare_exchange_weak(current, score);) {
+    }
+    CheckOptimal();
+  }
+
+  void UpdateLowerBound(int64_t bound) {
+    auto current = lower_bound.load();
+    for (; (bound > current) &&
+           !lower_bound.compare_exchange_weak(current, bound);) {
+    }
+    CheckOptimal();
+  }
+
+ protected:
+  void CheckOptimal() {
+    auto current = incumbent.load();
+    if ((current >= 0) && (current <= lower_bound.load())) Stop();
+  }
+};
+}  // namespace solvers
@@ -12,6 +12,8 @@ class Solution {
   void SetId(const std::string& new_id) { id = new_id; }
 
   bool Load(const std::string& /* id */, const std::string& /* filename */);
+  // Load for evaluation and copying only, solution data could stay in file.
+  bool LoadView(const std::string& /* id */, const std::string& /* filename */);
   void Save(const std::string& /* filename */) const;
 };
 }  // namespace solvers
@@ -1,5 +1,11 @@
 #pragma once
 
+#include "common/base.h"
+#include "common/memory/counter.h"
+#include "common/memory/system.h"
+#include "common/solvers/shared_bounds.h"
+#include "common/stats/registry.h"
+
 #include <memory>
 #include <string>
 
@@ -15,6 +21,14 @@ class Solver {
 
  protected:
   unsigned max_time_in_seconds;
+  // Bounds for optimal score found during last Solve call.
+  // lower_bound is 0 and incumbent is -1 when unknown.
+  int64_t lower_bound = 0;
+  int64_t incumbent = -1;
+  // Memory budget for single Solve call.
+  uint64_t max_memory_in_bytes = (1ull << 32);
+  // Bounds shared with other solvers racing on the same problem (optional).
+  std::shared_ptr<SharedBounds> shared_bounds;
 
  public:
   Solver() : max_time_in_seconds(-1u) {}
@@ -27,6 +41,45 @@ class Solver {
   virtual bool SkipSolutionWrite() const { return false; }
   virtual bool SkipBest() const { return false; }
 
+  int64_t LowerBound() const { return lower_bound; }
+  int64_t Incumbent() const { return incumbent; }
+
+  void SetMaxMemory(uint64_t bytes) { max_memory_in_bytes = bytes; }
+  void SetSharedBounds(const std::shared_ptr<SharedBounds>& bounds) {
+    shared_bounds = bounds;
+  }
+
+ protected:
+  // Accounted memory of search plus extra bytes tracked by solver is checked
+  // against own budget, RSS of the process against global limit.
+  bool OverMemory(const memory::Counter& counter, size_t extra = 0) const {
+    return (counter.Bytes() + extra > max_memory_in_bytes) ||
+           memory::ProcessOverLimit();
+  }
+
+  // Why search was stopped: 0 - finished, 1 - time limit, 2 - memory limit,
+  // 3 - race was stopped.
+  static void ReportStatus(unsigned status) {
+    static const char* names[] = {"status_finished", "status_time_limit",
+                                  "status_memory_limit", "status_race_stopped"};
+    if (status < 4) stats::Add(names[status]);
+  }
+
+  // Other solver of the race proved optimality.
+  bool RaceStopped() const {
+    return shared_bounds && shared_bounds->Stopped();
+  }
+
+  // Publishes own incumbent score (-1 if none) and returns the best one known
+  // in race (-1 if unknown). Without race own score is returned.
+  int64_t RaceExchange(int64_t own_incumbent) const {
+    if (!shared_bounds) return own_incumbent;
+    shared_bounds->UpdateIncumbent(own_incumbent);
+    return shared_bounds->Incumbent();
+  }
+
+ public:
+
   virtual std::string Name() const { return ""; }
   virtual TSolution Solve(const TProblem&) { return {}; }
 };
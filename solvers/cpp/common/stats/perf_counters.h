@@ -0,0 +1,245 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/stats/registry.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace stats {
+// Hardware counters of the calling thread (user space only) via Linux
+// perf_event_open. Events that can't be opened (no PMU in VM, restricted
+// perf_event_paranoid) are skipped, on other systems nothing is available.
+class PerfCounters {
+ public:
+  class Event {
+   public:
+    std::string name;
+    uint32_t type;
+    uint64_t config;
+  };
+
+  static std::vector<Event> DefaultEvents() {
+#ifdef __linux__
+    const uint64_t l1d_read_miss =
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    return {{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {"l1d_misses", PERF_TYPE_HW_CACHE, l1d_read_miss},
+            {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {"branch_misses", PERF_TYPE_HARDWARE,
+             PERF_COUNT_HW_BRANCH_MISSES}};
+#else
+    return {};
+#endif
+  }
+
+ protected:
+  std::vector<Event> events;  // Opened events only
+  std::vector<int> fds;
+  // Read buffer: nr, time_enabled, time_running, values.
+  std::vector<uint64_t> buffer;
+  // Cost of Read itself, subtracted from region samples.
+  std::vector<uint64_t> read_overhead;
+
+ public:
+  PerfCounters() {}
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  ~PerfCounters() { Close(); }
+
+  // Returns false if no event is available.
+  bool Open() {
+    Close();
+#ifdef __linux__
+    for (auto& e : DefaultEvents()) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = e.type;
+      attr.config = e.config;
+      attr.disabled = fds.empty() ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      int fd = int(syscall(SYS_perf_event_open, &attr, 0, -1,
+                           fds.empty() ? -1 : fds[0], 0));
+      if (fd < 0) continue;
+      fds.push_back(fd);
+      events.push_back(e);
+    }
+#endif
+    buffer.resize(3 + fds.size());
+    read_overhead.assign(fds.size(), 0);
+    return !fds.empty();
+  }
+
+  void Close() {
+#ifdef __linux__
+    for (int fd : fds) close(fd);
+#endif
+    fds.clear();
+    events.clear();
+  }
+
+  bool Good() const { return !fds.empty(); }
+  const std::vector<Event>& Events() const { return events; }
+
+  void Start() {
+#ifdef __linux__
+    if (!Good()) return;
+    ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  void Stop() {
+#ifdef __linux__
+    if (!Good()) return;
+    ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  // Raw values since Start. If scale is set, values are extrapolated for
+  // time counters were multiplexed out.
+  bool Read(std::vector<uint64_t>& values, bool scale = false) {
+    values.assign(fds.size(), 0);
+#ifdef __linux__
+    if (!Good()) return false;
+    auto size = buffer.size() * sizeof(uint64_t);
+    if (read(fds[0], buffer.data(), size) != ssize_t(size)) return false;
+    double k = (scale && buffer[2] && (buffer[2] < buffer[1]))
+                   ? double(buffer[1]) / buffer[2]
+                   : 1.;
+    for (size_t i = 0; i < fds.size(); ++i)
+      values[i] = uint64_t(buffer[3 + i] * k);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // Measures minimal difference between two back to back reads. Counters
+  // are left stopped.
+  void Calibrate(unsigned nreads = 64) {
+    std::vector<uint64_t> v0, v1;
+    read_overhead.assign(fds.size(), uint64_t(-1));
+    Start();
+    for (unsigned k = 0; k < nreads; ++k) {
+      if (!Read(v0) || !Read(v1)) break;
+      for (size_t i = 0; i < fds.size(); ++i)
+        read_overhead[i] = std::min(read_overhead[i], v1[i] - v0[i]);
+    }
+    Stop();
+    for (auto& x : read_overhead) {
+      if (x == uint64_t(-1)) x = 0;
+    }
+  }
+
+  const std::vector<uint64_t>& ReadOverhead() const { return read_overhead; }
+};
+
+// Counters used by PerfSampler in current thread, null if disabled.
+inline PerfCounters*& CurrentPerfCounters() {
+  thread_local PerfCounters* counters = nullptr;
+  return counters;
+}
+
+// Samples counters around hot region (heap pop, table probe) once per
+// period calls. Reading counters is a system call, so every call can't be
+// measured; totals are extrapolated by number of calls. Without active
+// counters the cost is an increment and a branch.
+class PerfSampler {
+ protected:
+  std::string name;
+  uint64_t mask;
+  uint64_t calls = 0;
+  uint64_t samples = 0;
+  PerfCounters* counters = nullptr;
+  std::vector<uint64_t> start, end, totals;
+
+ public:
+  // period must be a power of 2.
+  explicit PerfSampler(const std::string& _name, uint64_t period = 1024)
+      : name(_name), mask(period - 1) {}
+
+  void Reset() {
+    calls = samples = 0;
+    totals.clear();
+  }
+
+  void Begin() {
+    if ((calls++ & mask) != 0) return;
+    counters = CurrentPerfCounters();
+    if (counters && !counters->Read(start)) counters = nullptr;
+  }
+
+  void End() {
+    if (!counters) return;
+    if (counters->Read(end)) {
+      auto& overhead = counters->ReadOverhead();
+      totals.resize(end.size(), 0);
+      for (size_t i = 0; i < end.size(); ++i) {
+        auto d = end[i] - start[i];
+        totals[i] += (d > overhead[i]) ? d - overhead[i] : 0;
+      }
+      ++samples;
+    }
+    counters = nullptr;
+  }
+
+  // Adds perf_<name>_<event> (estimated totals) and perf_<name>_samples.
+  void Report() const {
+    auto c = CurrentPerfCounters();
+    if (!samples || !c || !Active()) return;
+    auto& events = c->Events();
+    double k = double(calls) / samples;
+    for (size_t i = 0; i < std::min(events.size(), totals.size()); ++i)
+      Add("perf_" + name + "_" + events[i].name, totals[i] * k);
+    Add("perf_" + name + "_samples", samples);
+  }
+};
+
+// Opens counters for current thread while alive, counts from Start to Stop
+// are added to stats as perf_<event>.
+class PerfScope {
+ protected:
+  PerfCounters counters;
+  PerfCounters* previous;
+  std::vector<uint64_t> values;
+
+ public:
+  PerfScope() : previous(CurrentPerfCounters()) {
+    if (counters.Open()) {
+      counters.Calibrate();
+      CurrentPerfCounters() = &counters;
+    }
+  }
+
+  PerfScope(const PerfScope&) = delete;
+  PerfScope& operator=(const PerfScope&) = delete;
+
+  ~PerfScope() { CurrentPerfCounters() = previous; }
+
+  bool Good() const { return counters.Good(); }
+
+  void Start() { counters.Start(); }
+
+  void Stop() {
+    counters.Read(values, true);
+    counters.Stop();
+    auto& events = counters.Events();
+    for (size_t i = 0; i < std::min(events.size(), values.size()); ++i)
+      Add("perf_" + events[i].name, values[i]);
+  }
+};
+}  // namespace stats
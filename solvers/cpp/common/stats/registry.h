@@ -0,0 +1,213 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace stats {
+// Distribution of non-negative values, log2 buckets.
+class Histogram {
+ public:
+  static constexpr unsigned nbuckets = 65;
+
+  uint64_t count = 0;
+  double sum = 0;
+  double min = 0;
+  double max = 0;
+  uint64_t buckets[nbuckets] = {};
+
+  // Bucket k > 0 keeps values in [2^(k-1), 2^k).
+  static unsigned Bucket(double value) {
+    if (value < 1) return 0;
+    int e;
+    std::frexp(value, &e);
+    return std::min<unsigned>(unsigned(e), nbuckets - 1);
+  }
+
+  void Add(double value) {
+    min = count ? std::min(min, value) : value;
+    max = count ? std::max(max, value) : value;
+    ++count;
+    sum += value;
+    ++buckets[Bucket(value)];
+  }
+
+  void Merge(const Histogram& r) {
+    if (!r.count) return;
+    min = count ? std::min(min, r.min) : r.min;
+    max = count ? std::max(max, r.max) : r.max;
+    count += r.count;
+    sum += r.sum;
+    for (unsigned i = 0; i < nbuckets; ++i) buckets[i] += r.buckets[i];
+  }
+
+  double Mean() const { return count ? sum / count : 0.; }
+
+  // Upper end of bucket with q-quantile (clamped by max).
+  double Quantile(double q) const {
+    uint64_t k = uint64_t(q * count), s = 0;
+    for (unsigned i = 0; i < nbuckets; ++i) {
+      s += buckets[i];
+      if (s > k) return std::min(max, (i == 0) ? 1. : std::ldexp(1., i));
+    }
+    return max;
+  }
+};
+
+// Counters (summed), maxima and histograms by name.
+class Values {
+ public:
+  std::map<std::string, double, std::less<>> counters;
+  std::map<std::string, double, std::less<>> maxima;
+  std::map<std::string, Histogram, std::less<>> histograms;
+
+ protected:
+  template <class TMap>
+  static typename TMap::mapped_type& Get(TMap& m, std::string_view name,
+                                         bool& inserted) {
+    auto it = m.find(name);
+    inserted = (it == m.end());
+    if (inserted)
+      it = m.emplace(std::string(name), typename TMap::mapped_type()).first;
+    return it->second;
+  }
+
+ public:
+  bool Empty() const {
+    return counters.empty() && maxima.empty() && histograms.empty();
+  }
+
+  void Add(std::string_view name, double value) {
+    bool inserted;
+    Get(counters, name, inserted) += value;
+  }
+
+  void Max(std::string_view name, double value) {
+    bool inserted;
+    auto& x = Get(maxima, name, inserted);
+    x = inserted ? value : std::max(x, value);
+  }
+
+  void Record(std::string_view name, double value) {
+    bool inserted;
+    Get(histograms, name, inserted).Add(value);
+  }
+
+  void Merge(const Values& r) {
+    for (auto& it : r.counters) Add(it.first, it.second);
+    for (auto& it : r.maxima) Max(it.first, it.second);
+    bool inserted;
+    for (auto& it : r.histograms)
+      Get(histograms, it.first, inserted).Merge(it.second);
+  }
+
+  // One line per value.
+  std::string ToString() const {
+    std::ostringstream ss;
+    ss << std::setprecision(15);
+    for (auto& it : counters)
+      ss << "\t" << it.first << " = " << it.second << "\n";
+    for (auto& it : maxima)
+      ss << "\t" << it.first << " = " << it.second << "\n";
+    for (auto& it : histograms) {
+      auto& h = it.second;
+      ss << "\t" << it.first << ": count = " << h.count
+         << ", mean = " << h.Mean() << ", p50 <= " << h.Quantile(0.5)
+         << ", p90 <= " << h.Quantile(0.9) << ", max = " << h.max << "\n";
+    }
+    return ss.str();
+  }
+};
+
+// Values for one unit of work (usually problem) from all threads working on
+// it. Threads write into own shard (see Attach), shards are merged under lock
+// when thread detaches.
+class Collector {
+ protected:
+  mutable std::mutex mutex;
+  Values values;
+
+ public:
+  void Merge(const Values& shard) {
+    std::lock_guard<std::mutex> lock(mutex);
+    values.Merge(shard);
+  }
+
+  Values Snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return values;
+  }
+};
+
+// Shard of current thread, null if nothing is collected.
+inline Values*& CurrentShard() {
+  thread_local Values* shard = nullptr;
+  return shard;
+}
+
+// Directs stats of current thread into collector while alive.
+class Attach {
+ protected:
+  Collector& collector;
+  Values shard;
+  Values* previous;
+
+ public:
+  explicit Attach(Collector& _collector)
+      : collector(_collector), previous(CurrentShard()) {
+    CurrentShard() = &shard;
+  }
+
+  Attach(const Attach&) = delete;
+  Attach& operator=(const Attach&) = delete;
+
+  ~Attach() {
+    CurrentShard() = previous;
+    collector.Merge(shard);
+  }
+};
+
+// Runners create collectors only if stats are enabled, without collector
+// every call below is one thread local load and branch.
+inline std::atomic<bool>& EnabledFlag() {
+  static std::atomic<bool> enabled(false);
+  return enabled;
+}
+
+inline bool Enabled() { return EnabledFlag().load(std::memory_order_relaxed); }
+inline void SetEnabled(bool enabled) { EnabledFlag() = enabled; }
+
+inline bool Active() { return CurrentShard() != nullptr; }
+
+inline void Add(std::string_view name, double value = 1) {
+  auto shard = CurrentShard();
+  if (shard) shard->Add(name, value);
+}
+
+inline void Max(std::string_view name, double value) {
+  auto shard = CurrentShard();
+  if (shard) shard->Max(name, value);
+}
+
+inline void Record(std::string_view name, double value) {
+  auto shard = CurrentShard();
+  if (shard) shard->Record(name, value);
+}
+
+// Prints values as one block, so output from different threads doesn't
+// interleave.
+inline void Print(const std::string& title, const Values& values) {
+  if (values.Empty()) return;
+  std::cout << (title + ":\n" + values.ToString()) << std::flush;
+}
+}  // namespace stats
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/timer.h"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stats {
+// Timeline in Chrome trace-event JSON format (chrome://tracing or
+// ui.perfetto.dev). Spans are complete events ("X") per thread, improvements
+// are instant events ("i"). Timestamps are microseconds since Enable.
+class Trace {
+ public:
+  using TArgs = std::vector<std::pair<std::string, std::string>>;
+
+  class Event {
+   public:
+    std::string name;
+    std::string category;
+    char phase;
+    size_t ts;
+    size_t duration;
+    unsigned tid;
+    TArgs args;
+  };
+
+ protected:
+  std::atomic<bool> enabled;
+  Timer timer;
+  std::mutex mutex;
+  std::vector<Event> events;
+
+  Trace() : enabled(false) {}
+
+  static std::string Escape(const std::string& s) {
+    std::string output;
+    for (char c : s) {
+      if ((c == '"') || (c == '\\')) output += '\\';
+      output += c;
+    }
+    return output;
+  }
+
+ public:
+  static Trace& Instance() {
+    static Trace trace;
+    return trace;
+  }
+
+  bool Enabled() const { return enabled.load(std::memory_order_relaxed); }
+
+  void Enable() {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    timer.Start();
+    enabled = true;
+  }
+
+  size_t Now() const { return timer.GetMicroseconds(); }
+
+  // Small sequential ids are easier to read than native thread ids.
+  static unsigned ThreadId() {
+    static std::atomic<unsigned> next(0);
+    thread_local unsigned id = next++;
+    return id;
+  }
+
+  void Add(Event&& e) {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.emplace_back(std::move(e));
+  }
+
+  void Write(std::ostream& s) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::set<unsigned> tids;
+    s << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (auto& e : events) {
+      tids.insert(e.tid);
+      s << (first ? "" : ",\n") << "{\"name\": \"" << Escape(e.name)
+        << "\", \"cat\": \"" << Escape(e.category) << "\", \"ph\": \""
+        << e.phase << "\", \"ts\": " << e.ts;
+      if (e.phase == 'X') s << ", \"dur\": " << e.duration;
+      if (e.phase == 'i') s << ", \"s\": \"t\"";
+      s << ", \"pid\": 1, \"tid\": " << e.tid << ", \"args\": {";
+      for (size_t i = 0; i < e.args.size(); ++i)
+        s << (i ? ", " : "") << "\"" << Escape(e.args[i].first) << "\": \""
+          << Escape(e.args[i].second) << "\"";
+      s << "}}";
+      first = false;
+    }
+    for (auto tid : tids) {
+      s << (first ? "" : ",\n")
+        << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+        << tid << ", \"args\": {\"name\": \"thread " << tid << "\"}}";
+      first = false;
+    }
+    s << "\n]}\n";
+  }
+
+  bool Save(const std::string& filename) {
+    std::ofstream f(filename);
+    if (!f.is_open()) return false;
+    Write(f);
+    return f.good();
+  }
+};
+
+inline bool Tracing() { return Trace::Instance().Enabled(); }
+
+// Scoped span, does nothing if tracing is disabled.
+// Args are built by caller even if tracing is disabled, hot call sites
+// should pass function returning TArgs instead, it is called only if
+// tracing is enabled.
+class Span {
+ protected:
+  bool active;
+  Trace::Event event;
+
+  void Start(const std::string& name, const std::string& category,
+             Trace::TArgs&& args) {
+    event.name = name;
+    event.category = category;
+    event.phase = 'X';
+    event.args = std::move(args);
+    event.ts = Trace::Instance().Now();
+  }
+
+ public:
+  explicit Span(const std::string& name,
+                const std::string& category = "solver",
+                Trace::TArgs args = {})
+      : active(Tracing()) {
+    if (active) Start(name, category, std::move(args));
+  }
+
+  template <class TArgsFunction>
+  Span(const char* name, const char* category, TArgsFunction args)
+      : active(Tracing()) {
+    if (active) Start(name, category, args());
+  }
+
+  Span(const Span&) = delete;
+  Span& operator=(const Span&) = delete;
+
+  // Extra args known only at the end of span (result, status).
+  void AddArg(const std::string& key, const std::string& value) {
+    if (active) event.args.push_back({key, value});
+  }
+
+  ~Span() {
+    if (!active) return;
+    event.duration = Trace::Instance().Now() - event.ts;
+    event.tid = Trace::ThreadId();
+    Trace::Instance().Add(std::move(event));
+  }
+};
+
+inline void Instant(const std::string& name,
+                    const std::string& category = "solver",
+                    Trace::TArgs args = {}) {
+  if (!Tracing()) return;
+  Trace::Event e{name, category, 'i', Trace::Instance().Now(), 0,
+                 Trace::ThreadId(), std::move(args)};
+  Trace::Instance().Add(std::move(e));
+}
+
+// Same as above, args() is called only if tracing is enabled.
+template <class TArgsFunction>
+inline void Instant(const char* name, const char* category,
+                    TArgsFunction args) {
+  if (Tracing()) Instant(std::string(name), std::string(category), args());
+}
+
+// Enables tracing for its lifetime and saves trace on destruction, empty
+// filename disables tracing.
+class TraceFile {
+ protected:
+  std::string filename;
+
+ public:
+  explicit TraceFile(const std::string& _filename) : filename(_filename) {
+    if (!filename.empty()) Trace::Instance().Enable();
+  }
+
+  TraceFile(const TraceFile&) = delete;
+  TraceFile& operator=(const TraceFile&) = delete;
+
+  ~TraceFile() {
+    if (filename.empty()) return;
+    if (!Trace::Instance().Save(filename))
+      std::cerr << "Failed to save trace " << filename << std::endl;
+  }
+};
+}  // namespace stats
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <charconv>
+#include <string_view>
+#include <system_error>
+
+// Parses integers from s, any other characters are separators.
+// Calls f(value) for every integer, stops if f returns false.
+// Returns false if s contains integer out of range of T or '-' without
+// digits, values before it were already passed to f.
+template <class T, class TFunction>
+inline bool ParseIntegers(std::string_view s, TFunction f) {
+  const char *p = s.data(), *end = s.data() + s.size();
+  for (;;) {
+    for (; (p < end) && (*p != '-') && ((*p < '0') || (*p > '9'));) ++p;
+    if (p == end) return true;
+    T value;
+    auto r = std::from_chars(p, end, value);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    if (!f(value)) return true;
+  }
+}
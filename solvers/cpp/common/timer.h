@@ -2,19 +2,23 @@
 
 #include <chrono>
 
+// Monotonic clock, so intervals are not affected by system time changes.
 class Timer {
+ public:
+  using TClock = std::chrono::steady_clock;
+
  protected:
   bool running;
-  std::chrono::time_point<std::chrono::system_clock> start_time, end_time;
+  TClock::time_point start_time, end_time;
 
  public:
   void Start() {
-    start_time = std::chrono::system_clock::now();
+    start_time = TClock::now();
     running = true;
   }
 
   void Stop() {
-    end_time = std::chrono::system_clock::now();
+    end_time = TClock::now();
     running = false;
   }
 
@@ -23,24 +27,21 @@ class Timer {
   }
 
   size_t GetMicroseconds() const {
-    std::chrono::time_point<std::chrono::system_clock> time =
-        running ? std::chrono::system_clock::now() : end_time;
+    TClock::time_point time = running ? TClock::now() : end_time;
     return std::chrono::duration_cast<std::chrono::microseconds>(time -
                                                                  start_time)
         .count();
   }
 
   size_t GetMilliseconds() const {
-    std::chrono::time_point<std::chrono::system_clock> time =
-        running ? std::chrono::system_clock::now() : end_time;
+    TClock::time_point time = running ? TClock::now() : end_time;
     return std::chrono::duration_cast<std::chrono::milliseconds>(time -
                                                                  start_time)
         .count();
   }
 
   size_t GetSeconds() const {
-    std::chrono::time_point<std::chrono::system_clock> time =
-        running ? std::chrono::system_clock::now() : end_time;
+    TClock::time_point time = running ? TClock::now() : end_time;
     return std::chrono::duration_cast<std::chrono::seconds>(time - start_time)
         .count();
   }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "lambdaman/problem.h"
+#include "lambdaman/utils/bfs.h"
+#include "lambdaman/utils/bit_bfs.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace lambdaman {
+// Compares distances (and nearest sources) of Bfs and BitBfs with queue BFS
+// on mazes of problems, single and multi-source, with and without distance
+// limit, and distances from every source of BitBfs::RunBatch. Returns false
+// if any of them differ.
+inline bool CheckBfs(unsigned first_problem, unsigned last_problem) {
+  uint64_t total = 0;
+  for (unsigned i = first_problem; i <= last_problem; ++i) {
+    Problem p;
+    if (!p.Load(std::to_string(i))) {
+      std::cout << "Failed to load problem " << i << std::endl;
+      return false;
+    }
+    auto& maze = p.GetMaze();
+    auto pills = maze.Pills();
+    std::vector<unsigned> sparse;
+    for (unsigned k = 0; k < pills.size(); k += 16) sparse.push_back(pills[k]);
+    Bfs reference(maze), tested(maze);
+    BitBfs bit_bfs(maze);
+    std::vector<unsigned> bit_distance;
+    uint64_t mismatches = 0;
+    for (auto& sources : {std::vector<unsigned>{maze.Start()}, sparse, pills}) {
+      for (unsigned max_distance : {Bfs::unreachable, 8u}) {
+        reference.RunQueue(sources, max_distance);
+        tested.Run(sources, max_distance);
+        bit_bfs.Distances(sources, bit_distance, max_distance);
+        for (unsigned c = 0; c < maze.Size(); ++c) {
+          auto d = reference.Distance(c);
+          if ((tested.Distance(c) != d) || (bit_distance[c] != d) ||
+              ((d != Bfs::unreachable) &&
+               (tested.Source(c) != reference.Source(c))))
+            ++mismatches;
+        }
+        if (tested.Order().size() != reference.Order().size()) ++mismatches;
+      }
+    }
+    std::vector<unsigned> batch(
+        sparse.begin(), sparse.begin() + std::min<size_t>(sparse.size(), 64));
+    std::vector<std::vector<unsigned>> batch_distance(
+        batch.size(), std::vector<unsigned>(maze.Size(), Bfs::unreachable));
+    bit_bfs.RunBatch(batch, [&](unsigned c, unsigned d, uint64_t bits) {
+      for (; bits; bits &= bits - 1)
+        batch_distance[__builtin_ctzll(bits)][c] = d;
+    });
+    for (unsigned k = 0; k < batch.size(); ++k) {
+      reference.RunQueue({batch[k]});
+      for (unsigned c = 0; c < maze.Size(); ++c) {
+        if (batch_distance[k][c] != reference.Distance(c)) ++mismatches;
+      }
+    }
+    std::cout << "Problem " << std::to_string(1000 + i).substr(1) << "\t"
+              << mismatches << std::endl;
+    total += mismatches;
+  }
+  std::cout << "Mismatches = " << total << std::endl;
+  return total == 0;
+}
+}  // namespace lambdaman
@@ -0,0 +1,6 @@
+#pragma once
+
+namespace lambdaman {
+const unsigned last_problem = 21;
+const unsigned max_moves = 1000000;
+}  // namespace lambdaman
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "lambdaman/constants.h"
+#include "lambdaman/evaluator.h"
+#include "lambdaman/problem.h"
+#include "lambdaman/solution.h"
+
+#include "common/solvers/ext/evaluate.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace lambdaman {
+inline void EvaluateSolution(const std::string& solver_name) {
+  int64_t total = 0;
+  for (unsigned i = 1; i <= last_problem; ++i) {
+    auto r = solvers::ext::Evaluate<Evaluator, Problem, Solution>(
+        std::to_string(i), solver_name);
+    total += (r.correct ? std::max<int64_t>(r.score, 0) : int64_t(max_moves));
+    std::cout << "Problem " << std::to_string(1000 + i).substr(1) << "\t"
+              << r.correct << "\t" << r.score << std::endl;
+  }
+  std::cout << "Total = " << total << std::endl;
+}
+
+inline void UpdateBest(const std::string& solver_name) {
+  for (unsigned i = 1; i <= last_problem; ++i) {
+    auto b = solvers::ext::UpdateBest<Evaluator, Problem, Solution>(
+        std::to_string(i), solver_name, "best");
+    if (b) {
+      std::cout << "Best was updated for problem: " << i << std::endl;
+    }
+  }
+}
+}  // namespace lambdaman
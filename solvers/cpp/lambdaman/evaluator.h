@@ -0,0 +1,32 @@
+#pragma once
+
+#include "lambdaman/constants.h"
+#include "lambdaman/problem.h"
+#include "lambdaman/solution.h"
+#include "lambdaman/utils/simulator.h"
+
+#include "common/solvers/evaluator.h"
+
+namespace lambdaman {
+class Evaluator : public solvers::Evaluator {
+ public:
+  using Result = solvers::Evaluator::Result;
+
+  static bool Compare(const Result& l, const Result& r) {
+    return l.correct ? r.correct ? l.score < r.score : true : false;
+  }
+
+  // All pills are eaten within move limit.
+  static bool Valid(const Problem& p, const Solution& s) {
+    if (s.View().size() > max_moves) return false;
+    Simulator simulator(p.GetMaze());
+    return simulator.PillsLeft(s.View()) == 0;
+  }
+
+  // Simulation is sequential, nthreads is ignored.
+  static Result Apply(const Problem& p, const Solution& s,
+                      unsigned /* nthreads */ = 0) {
+    return Valid(p, s) ? Result(true, s.View().size()) : Result(false, 0);
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,91 @@
+#include "lambdaman/check_bfs.h"
+#include "lambdaman/constants.h"
+#include "lambdaman/evaluate_solution.h"
+#include "lambdaman/evaluator.h"
+#include "lambdaman/problem.h"
+#include "lambdaman/solution.h"
+#include "lambdaman/solvers/base.h"
+#include "lambdaman/solvers/greedy.h"
+#include "lambdaman/solvers/tour.h"
+
+#include "common/files/command_line.h"
+#include "common/memory/system.h"
+#include "common/solvers/ext/run_n.h"
+#include "common/stats/registry.h"
+#include "common/stats/trace.h"
+
+#include <algorithm>
+#include <memory>
+
+void InitCommaneLine(files::CommandLine& cmd) {
+  cmd.AddArg("mode", "eval");
+  cmd.AddArg("solution", "best");
+  cmd.AddArg("solver", "tour");
+  cmd.AddArg("timelimit", 60);
+  cmd.AddArg("cluster_size", 4);  // Tile size for pill clusters of tour
+  cmd.AddArg("tour_window", 1);  // Clusters of tour open for greedy walk
+  cmd.AddArg("nthreads", 4);
+  cmd.AddArg("memory_limit", 0);  // MB, 0 - 3/4 of physical memory
+  cmd.AddArg("stats", 1);  // Print solver stats per problem
+  cmd.AddArg("trace", "");  // Chrome trace-event JSON output file
+  cmd.AddArg("first_problem", 1);
+  cmd.AddArg("last_problem", lambdaman::last_problem);
+}
+
+lambdaman::BaseSolver::PSolver CreateSolver(const files::CommandLine& cmd,
+                                            const std::string& solver_name) {
+  auto timelimit = cmd.GetInt("timelimit");
+  if (solver_name == "greedy") {
+    return std::make_shared<lambdaman::Greedy>(timelimit);
+  } else if (solver_name == "tour") {
+    return std::make_shared<lambdaman::Tour>(
+        timelimit, cmd.GetInt("cluster_size"), cmd.GetInt("tour_window"));
+  } else {
+    std::cerr << "Unknown solver type: " << solver_name << std::endl;
+    exit(-1);
+  }
+}
+
+uint64_t MemoryLimit(const files::CommandLine& cmd) {
+  return (cmd.GetInt("memory_limit") > 0)
+             ? (uint64_t(cmd.GetInt("memory_limit")) << 20)
+             : memory::PhysicalMemory() / 4 * 3;
+}
+
+int main(int argc, char** argv) {
+  files::CommandLine cmd;
+  InitCommaneLine(cmd);
+  cmd.Parse(argc, argv);
+
+  stats::SetEnabled(cmd.GetInt("stats"));
+  stats::TraceFile trace_file(cmd.GetString("trace"));
+  const auto mode = cmd.GetString("mode");
+  if (mode == "eval") {
+    lambdaman::EvaluateSolution(cmd.GetString("solution"));
+  } else if (mode == "update") {
+    lambdaman::UpdateBest(cmd.GetString("solution"));
+  } else if (mode == "bfs_check") {
+    return lambdaman::CheckBfs(cmd.GetInt("first_problem"),
+                               cmd.GetInt("last_problem"))
+               ? 0
+               : 1;
+  } else if (mode == "run") {
+    auto solver_name = cmd.GetString("solver");
+    auto s = CreateSolver(cmd, solver_name);
+    int nthreads = cmd.GetInt("nthreads");
+    auto memory_limit = MemoryLimit(cmd);
+    memory::SetProcessLimit(memory_limit);
+    s->SetMaxMemory(memory_limit / std::max(nthreads, 1));
+    if (nthreads <= 0)
+      solvers::ext::RunN<lambdaman::BaseSolver>(*s, cmd.GetInt("first_problem"),
+                                                cmd.GetInt("last_problem"));
+    else
+      solvers::ext::RunNMT<lambdaman::BaseSolver>(
+          *s, cmd.GetInt("first_problem"), cmd.GetInt("last_problem"),
+          nthreads);
+  } else {
+    std::cerr << "Unknown mode " << mode << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lambdaman {
+// Move letters by direction index, next(c, d) follows the same order.
+inline constexpr char directions[] = "RDLU";
+
+// Maze as flat byte grid, row-major and padded with one wall cell on every
+// side, so neighbors of open cells never need bounds checks. Cells: '#' wall,
+// '.' pill, 'L' start, anything else is empty.
+class Maze {
+ protected:
+  unsigned width = 0, height = 0, stride = 0;
+  std::vector<char> cells;
+  unsigned start = 0;
+  int delta[4] = {0, 0, 0, 0};
+
+ public:
+  bool Parse(std::string_view text) {
+    std::vector<std::string_view> lines;
+    for (size_t b = 0; b < text.size();) {
+      auto e = text.find('\n', b);
+      if (e == std::string_view::npos) e = text.size();
+      auto line = text.substr(b, e - b);
+      if (!line.empty() && (line.back() == '\r')) line.remove_suffix(1);
+      if (!line.empty()) lines.push_back(line);
+      b = e + 1;
+    }
+    height = lines.size();
+    width = 0;
+    for (auto& line : lines) width = std::max<unsigned>(width, line.size());
+    stride = width + 2;
+    cells.assign((height + 2) * stride, '#');
+    delta[0] = 1;
+    delta[1] = int(stride);
+    delta[2] = -1;
+    delta[3] = -int(stride);
+    bool found = false;
+    for (unsigned r = 0; r < height; ++r) {
+      for (unsigned c = 0; c < lines[r].size(); ++c) {
+        auto x = Index(r, c);
+        cells[x] = lines[r][c];
+        if (cells[x] == 'L') {
+          start = x;
+          found = true;
+        }
+      }
+    }
+    return found;
+  }
+
+  unsigned Width() const { return width; }
+  unsigned Height() const { return height; }
+  unsigned Stride() const { return stride; }
+  // Number of cells including padding, cell indices are below it.
+  unsigned Size() const { return cells.size(); }
+
+  unsigned Index(unsigned row, unsigned col) const {
+    return (row + 1) * stride + (col + 1);
+  }
+  // Padded coordinates, border walls are row (col) 0 and height (width) + 1.
+  unsigned PRow(unsigned c) const { return c / stride; }
+  unsigned PCol(unsigned c) const { return c % stride; }
+
+  char Cell(unsigned c) const { return cells[c]; }
+  bool Wall(unsigned c) const { return cells[c] == '#'; }
+  bool Pill(unsigned c) const { return cells[c] == '.'; }
+  unsigned Start() const { return start; }
+
+  // Cell after move from c in direction d, c itself if blocked.
+  unsigned Next(unsigned c, unsigned d) const {
+    unsigned c1 = c + delta[d];
+    return Wall(c1) ? c : c1;
+  }
+
+  std::vector<unsigned> Pills() const {
+    std::vector<unsigned> v;
+    for (unsigned c = 0; c < Size(); ++c) {
+      if (Pill(c)) v.push_back(c);
+    }
+    return v;
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "lambdaman/maze.h"
+
+#include "common/files/mapped_file.h"
+#include "common/solvers/problem.h"
+
+#include <string>
+
+namespace lambdaman {
+class Problem : public solvers::Problem {
+ protected:
+  Maze maze;
+
+ public:
+  const Maze& GetMaze() const { return maze; }
+
+  bool Load(const std::string& _id) {
+    return Load(_id, "../../problems/lambdaman/lambdaman" + _id + ".txt");
+  }
+
+  bool Load(const std::string& _id, const std::string& filename) {
+    id = _id;
+    files::MappedFile f(filename);
+    return f.Good() && maze.Parse(f.View());
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "common/files/file_to_string.h"
+#include "common/solvers/solution.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace lambdaman {
+// Plain move string ("RDLU" letters). Stored apart from encoded programs of
+// other tools, in solutions/lambdaman/moves.
+class Solution : public solvers::Solution {
+ public:
+  std::string moves;
+
+ public:
+  bool Empty() const { return moves.empty(); }
+  void Clear() { moves.clear(); }
+  std::string_view View() const { return moves; }
+
+  static std::string FileName(const std::string& id,
+                              const std::string& solver_name) {
+    return "../../solutions/lambdaman/moves/" + solver_name + "/" + id +
+           ".txt";
+  }
+
+  // Moves are always stored as text.
+  static std::string StoredFileName(const std::string& id,
+                                    const std::string& solver_name) {
+    return FileName(id, solver_name);
+  }
+
+  static std::string BoundsFileName(const std::string& id) {
+    return "../../solutions/lambdaman/moves/bounds/" + id + ".txt";
+  }
+
+  static std::string IndexFileName(const std::string& solver_name) {
+    return "../../solutions/lambdaman/moves/index/" + solver_name + ".txt";
+  }
+
+  bool Load(const std::string& id, const std::string& solver_name) {
+    SetId(id);
+    moves = files::FileToString(FileName(GetId(), solver_name));
+    return !moves.empty();
+  }
+
+  bool LoadView(const std::string& id, const std::string& solver_name) {
+    return Load(id, solver_name);
+  }
+
+  void Save(const std::string& solver_name) const {
+    auto filename = FileName(GetId(), solver_name);
+    std::filesystem::create_directories(
+        std::filesystem::path(filename).parent_path());
+    std::ofstream f(filename, std::ios::binary);
+    f.write(moves.data(), moves.size());
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "lambdaman/evaluator.h"
+#include "lambdaman/problem.h"
+#include "lambdaman/solution.h"
+
+#include "common/solvers/solver.h"
+
+namespace lambdaman {
+using BaseSolver = solvers::Solver<Problem, Solution, Evaluator>;
+}  // namespace lambdaman
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "lambdaman/solvers/base.h"
+#include "lambdaman/utils/walker.h"
+
+#include "common/solvers/solver.h"
+#include "common/stats/registry.h"
+
+#include <string>
+
+namespace lambdaman {
+// Always goes to the nearest uneaten pill.
+class Greedy : public BaseSolver {
+ public:
+  using TBase = BaseSolver;
+  using PSolver = TBase::PSolver;
+
+ public:
+  Greedy() : BaseSolver() {}
+  explicit Greedy(unsigned _max_time) : BaseSolver(_max_time) {}
+
+  PSolver Clone() const override { return std::make_shared<Greedy>(*this); }
+
+  std::string Name() const override { return "greedy"; }
+
+  static std::string SolveI(const Maze& maze) {
+    Walker w(maze);
+    for (; w.PillsLeft() && w.GoToNearestPill();) {
+    }
+    stats::Add("pills_unreachable", w.PillsLeft());
+    return w.Moves();
+  }
+
+  Solution Solve(const Problem& p) override {
+    Solution s;
+    s.SetId(p.Id());
+    s.moves = SolveI(p.GetMaze());
+    return s;
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,261 @@
+#pragma once
+
+#include "lambdaman/solvers/base.h"
+#include "lambdaman/solvers/greedy.h"
+#include "lambdaman/utils/pill_clusters.h"
+#include "lambdaman/utils/walker.h"
+
+#include "common/solvers/solver.h"
+#include "common/stats/registry.h"
+#include "common/stats/trace.h"
+#include "common/timer.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace lambdaman {
+// Open tour from start over pill clusters (BFS distances between
+// representatives), from nearest neighbour and from the order of greedy walk,
+// improved by 2-opt and Or-opt until local optimum or time limit. The walk
+// follows tour: it goes to the nearest pill of the first window clusters
+// with pills left. The shortest of these walks and greedy walk is returned.
+class Tour : public BaseSolver {
+ public:
+  using TBase = BaseSolver;
+  using PSolver = TBase::PSolver;
+
+ protected:
+  unsigned cluster_size;
+  unsigned window;
+
+ public:
+  Tour() : BaseSolver(), cluster_size(4), window(1) {}
+  explicit Tour(unsigned _max_time, unsigned _cluster_size = 4,
+                unsigned _window = 1)
+      : BaseSolver(_max_time),
+        cluster_size(std::max(_cluster_size, 1u)),
+        window(std::max(_window, 1u)) {}
+
+  PSolver Clone() const override { return std::make_shared<Tour>(*this); }
+
+  std::string Name() const override { return "tour"; }
+
+ protected:
+  class Path {
+   public:
+    const PillClusters& clusters;
+    const std::vector<unsigned>& from_start;
+    std::vector<unsigned> order;
+
+    // Cost of edge to order[i] from its predecessor (start for i = 0).
+    unsigned In(int i, unsigned v) const {
+      return (i == 0) ? from_start[v] : clusters.Distance(order[i - 1], v);
+    }
+
+    int64_t Length() const {
+      int64_t l = 0;
+      for (unsigned i = 0; i < order.size(); ++i) l += In(i, order[i]);
+      return l;
+    }
+  };
+
+  static std::vector<unsigned> NearestNeighbour(
+      const PillClusters& clusters, const std::vector<unsigned>& from_start) {
+    unsigned n = clusters.Size();
+    std::vector<unsigned> order;
+    std::vector<char> used(n, 0);
+    for (unsigned k = 0; k < n; ++k) {
+      unsigned best = 0, best_distance = PillClusters::none;
+      for (unsigned i = 0; i < n; ++i) {
+        if (used[i]) continue;
+        auto d = order.empty() ? from_start[i]
+                               : clusters.Distance(order.back(), i);
+        if (d < best_distance) {
+          best = i;
+          best_distance = d;
+        }
+      }
+      if (best_distance == PillClusters::none) break;
+      used[best] = 1;
+      order.push_back(best);
+    }
+    return order;
+  }
+
+  // Reverses order[i..j] if it makes path shorter.
+  static bool TwoOpt(Path& path, const Timer& t, unsigned max_time) {
+    auto& order = path.order;
+    int n = order.size();
+    bool improved = false;
+    for (int i = 0; i < n; ++i) {
+      if (t.GetSeconds() >= max_time) break;
+      for (int j = i + 1; j < n; ++j) {
+        int64_t old_cost = path.In(i, order[i]);
+        int64_t new_cost = path.In(i, order[j]);
+        if (j + 1 < n) {
+          old_cost += path.clusters.Distance(order[j], order[j + 1]);
+          new_cost += path.clusters.Distance(order[i], order[j + 1]);
+        }
+        if (new_cost < old_cost) {
+          std::reverse(order.begin() + i, order.begin() + j + 1);
+          improved = true;
+          stats::Add("two_opt_moves");
+        }
+      }
+    }
+    return improved;
+  }
+
+  // Moves segment of 1-3 clusters to other place if it makes path shorter.
+  static bool OrOpt(Path& path, const Timer& t, unsigned max_time) {
+    auto& order = path.order;
+    int n = order.size();
+    auto& cl = path.clusters;
+    bool improved = false;
+    for (int len = 1; len <= 3; ++len) {
+      for (int i = 0; i + len <= n; ++i) {
+        if (t.GetSeconds() >= max_time) return improved;
+        int j = i + len - 1;
+        // Removal gain.
+        int64_t removed = path.In(i, order[i]);
+        int64_t joined = 0;
+        if (j + 1 < n) {
+          removed += cl.Distance(order[j], order[j + 1]);
+          joined = (i == 0) ? path.from_start[order[j + 1]]
+                            : cl.Distance(order[i - 1], order[j + 1]);
+        }
+        int64_t gain = removed - joined;
+        if (gain <= 0) continue;
+        // Insert between k and k + 1 (k = -1 - after start), outside of
+        // segment and its neighbors.
+        int best_k = -2;
+        int64_t best_delta = gain;
+        for (int k = -1; k < n; ++k) {
+          if ((k >= i - 1) && (k <= j)) continue;
+          unsigned a = order[i], b = order[j];
+          int64_t before = (k < 0) ? path.from_start[a]
+                                   : cl.Distance(order[k], a);
+          int64_t after = (k + 1 < n) ? cl.Distance(b, order[k + 1]) : 0;
+          int64_t old_edge = (k + 1 < n) ? path.In(k + 1, order[k + 1]) : 0;
+          int64_t delta = before + after - old_edge;
+          if (delta < best_delta) {
+            best_delta = delta;
+            best_k = k;
+          }
+        }
+        if (best_k == -2) continue;
+        std::vector<unsigned> segment(order.begin() + i,
+                                      order.begin() + j + 1);
+        order.erase(order.begin() + i, order.begin() + j + 1);
+        int insert_at = (best_k < i) ? best_k + 1 : best_k + 1 - len;
+        order.insert(order.begin() + insert_at, segment.begin(),
+                     segment.end());
+        improved = true;
+        stats::Add("or_opt_moves");
+      }
+    }
+    return improved;
+  }
+
+ public:
+  // Order of clusters by their first eaten pill.
+  static std::vector<unsigned> ClusterOrder(const Maze& maze,
+                                            const PillClusters& clusters,
+                                            const std::string& moves) {
+    std::vector<unsigned> order;
+    std::vector<char> used(clusters.Size(), 0);
+    unsigned pos = maze.Start();
+    for (char m : moves) {
+      pos = maze.Next(pos, std::find(directions, directions + 4, m) -
+                               directions);
+      auto i = clusters.Cluster(pos);
+      if ((i != PillClusters::none) && !used[i]) {
+        used[i] = 1;
+        order.push_back(i);
+      }
+    }
+    return order;
+  }
+
+  // Walk that goes to the nearest pill of the first window clusters of order
+  // with pills left.
+  std::string Expand(const Maze& maze, const PillClusters& clusters,
+                     const std::vector<unsigned>& order) const {
+    Walker w(maze);
+    std::vector<unsigned> rank(clusters.Size(), clusters.Size());
+    for (unsigned k = 0; k < order.size(); ++k) rank[order[k]] = k;
+    auto done = [&](unsigned k) {
+      for (auto c : clusters.Cells(order[k])) {
+        if (!w.Eaten(c)) return false;
+      }
+      return true;
+    };
+    for (unsigned first = 0; first < order.size();) {
+      if (done(first) || !w.GoToNearest([&](unsigned c) {
+            return rank[clusters.Cluster(c)] < first + window;
+          }))
+        ++first;
+    }
+    // Pills unreachable from cluster order (none for connected mazes).
+    for (; w.PillsLeft() && w.GoToNearestPill();) {
+    }
+    return w.Moves();
+  }
+
+  // Tour from initial order, local search gets time until deadline (seconds
+  // since t).
+  std::string SolveI(const Maze& maze, const PillClusters& clusters,
+                     const std::vector<unsigned>& from_start,
+                     std::vector<unsigned> order, const Timer& t,
+                     unsigned deadline, const std::string& name) const {
+    Path path{clusters, from_start, order};
+    stats::Span span("SolveI", "solver", {{"solver", "tour"}, {"init", name}});
+    auto initial_length = path.Length();
+    for (; TwoOpt(path, t, deadline) || OrOpt(path, t, deadline);) {
+    }
+    stats::Add("tour_length_initial_" + name, initial_length);
+    stats::Add("tour_length_" + name, path.Length());
+    return Expand(maze, clusters, path.order);
+  }
+
+  Solution Solve(const Problem& p) override {
+    Timer t;
+    auto& maze = p.GetMaze();
+    PillClusters clusters;
+    clusters.Build(maze, maze.Pills(), cluster_size);
+    clusters.ComputeDistances(maze);
+    stats::Record("apsp_ms", t.GetMilliseconds());
+    stats::Add("clusters", clusters.Size());
+
+    Bfs bfs(maze);
+    bfs.Run(maze.Start());
+    std::vector<unsigned> from_start(clusters.Size());
+    for (unsigned i = 0; i < clusters.Size(); ++i)
+      from_start[i] = bfs.Distance(clusters.Representative(i));
+
+    // Greedy walk is a candidate itself and gives the second initial order.
+    auto greedy = Greedy::SolveI(maze);
+    std::string best = greedy, best_name = "greedy";
+    uint64_t elapsed = std::min<uint64_t>(max_time_in_seconds, t.GetSeconds());
+    uint64_t time_left = max_time_in_seconds - elapsed;
+    std::vector<std::pair<std::string, std::vector<unsigned>>> inits{
+        {"nn", NearestNeighbour(clusters, from_start)},
+        {"greedy", ClusterOrder(maze, clusters, greedy)}};
+    for (unsigned k = 0; k < inits.size(); ++k) {
+      unsigned deadline = elapsed + time_left * (k + 1) / inits.size();
+      auto moves = SolveI(maze, clusters, from_start, inits[k].second, t,
+                          deadline, inits[k].first);
+      if (moves.size() < best.size()) {
+        best.swap(moves);
+        best_name = "tour_" + inits[k].first;
+      }
+    }
+    stats::Add("winner_" + best_name);
+    Solution s;
+    s.SetId(p.Id());
+    s.moves = best;
+    return s;
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "lambdaman/maze.h"
+#include "lambdaman/utils/bit_bfs.h"
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace lambdaman {
+// Queue BFS over open cells, single or multi-source. Results are stamped with
+// run number, so a run costs only the cells it reaches (Nearest usually stops
+// after a few of them) and doesn't clear arrays of maze size. Multi-source
+// runs expand layers with BitBfs (wide frontiers), nearest sources are
+// restored from distances afterwards.
+class Bfs {
+ public:
+  static constexpr unsigned unreachable = std::numeric_limits<unsigned>::max();
+
+ protected:
+  const Maze& maze;
+  std::vector<unsigned> stamp;
+  unsigned epoch = 0;
+  std::vector<unsigned> distance;
+  // Index of nearest source in sources of last run.
+  std::vector<unsigned> source;
+  std::vector<unsigned> queue;
+  std::optional<BitBfs> bit_bfs;  // Created by the first multi-source run.
+
+  void NextEpoch() {
+    if (++epoch == 0) {
+      std::fill(stamp.begin(), stamp.end(), 0u);
+      epoch = 1;
+    }
+    queue.clear();
+  }
+
+  void Push(unsigned c, unsigned d, unsigned s) {
+    stamp[c] = epoch;
+    distance[c] = d;
+    source[c] = s;
+    queue.push_back(c);
+  }
+
+  // Queue BFS visits layer d in order of sources of cells, so cell is
+  // reached first from neighbor of layer d - 1 with the smallest source.
+  void RunBits(const std::vector<unsigned>& sources, unsigned max_distance) {
+    NextEpoch();
+    if (!bit_bfs) bit_bfs.emplace(maze);
+    bit_bfs->Run(sources, max_distance,
+                 [&](unsigned c, unsigned d) { Push(c, d, unreachable); });
+    for (unsigned i = sources.size(); i-- > 0;) {
+      if (Reached(sources[i])) source[sources[i]] = i;
+    }
+    for (auto c : queue) {
+      if (distance[c] == 0) continue;
+      for (unsigned dir = 0; dir < 4; ++dir) {
+        unsigned c1 = maze.Next(c, dir);
+        if (Reached(c1) && (distance[c1] + 1 == distance[c]))
+          source[c] = std::min(source[c], source[c1]);
+      }
+    }
+  }
+
+ public:
+  explicit Bfs(const Maze& _maze)
+      : maze(_maze),
+        stamp(maze.Size(), 0),
+        distance(maze.Size(), 0),
+        source(maze.Size(), 0) {
+    queue.reserve(maze.Size());
+  }
+
+  // Distances to the nearest of sources (within max_distance), ties go to the
+  // source with smaller index.
+  void Run(const std::vector<unsigned>& sources,
+           unsigned max_distance = unreachable) {
+    if (sources.size() > 1)
+      RunBits(sources, max_distance);
+    else
+      RunQueue(sources, max_distance);
+  }
+
+  void Run(unsigned from, unsigned max_distance = unreachable) {
+    RunQueue(std::vector<unsigned>{from}, max_distance);
+  }
+
+  // Run without BitBfs, reference for it (lambdaman -mode bfs_check).
+  void RunQueue(const std::vector<unsigned>& sources,
+                unsigned max_distance = unreachable) {
+    NextEpoch();
+    for (unsigned i = 0; i < sources.size(); ++i) {
+      if (!Reached(sources[i]) && !maze.Wall(sources[i]))
+        Push(sources[i], 0, i);
+    }
+    for (size_t k = 0; k < queue.size(); ++k) {
+      unsigned c = queue[k], d = distance[c];
+      if (d >= max_distance) break;
+      for (unsigned dir = 0; dir < 4; ++dir) {
+        unsigned c1 = maze.Next(c, dir);
+        if (!Reached(c1)) Push(c1, d + 1, source[c]);
+      }
+    }
+  }
+
+  // Closest cell (ties by direction order) with pred(cell) from from, returns
+  // {cell, distance} or {unreachable, unreachable}.
+  template <class TPred>
+  std::pair<unsigned, unsigned> Nearest(unsigned from, TPred pred) {
+    NextEpoch();
+    Push(from, 0, 0);
+    for (size_t k = 0; k < queue.size(); ++k) {
+      unsigned c = queue[k];
+      if (pred(c)) return {c, distance[c]};
+      for (unsigned dir = 0; dir < 4; ++dir) {
+        unsigned c1 = maze.Next(c, dir);
+        if (!Reached(c1)) Push(c1, distance[c] + 1, 0);
+      }
+    }
+    return {unreachable, unreachable};
+  }
+
+  bool Reached(unsigned c) const { return stamp[c] == epoch; }
+
+  unsigned Distance(unsigned c) const {
+    return Reached(c) ? distance[c] : unreachable;
+  }
+
+  // Valid for reached cells only.
+  unsigned Source(unsigned c) const { return source[c]; }
+
+  // Reached cells of last run in order of distance.
+  const std::vector<unsigned>& Order() const { return queue; }
+};
+}  // namespace lambdaman
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "lambdaman/maze.h"
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace lambdaman {
+// Bit-parallel BFS: every padded row is a few 64-bit words (one bit per cell)
+// and a whole frontier layer is expanded at once, left and right neighbors
+// by shifts with carry between words, up and down by the words of adjacent
+// rows. Every row ends with a zero guard word, so carries need no branches,
+// and only rows next to non-empty frontier rows (kept in a list) are
+// processed. Layer cost is words of those rows, not cells, so it wins when
+// layers are few and wide (multi-source from many pills, open areas) and for
+// set queries (CountWithin needs no per-cell work at all); long corridors
+// and single source on large mazes are faster with Bfs.
+// RunBatch is the other way around: up to 64 separate BFS at once, one bit
+// per source in word of every cell. Cell is expanded once per distinct
+// distance from sources of batch, so nearby sources (all-pairs distances)
+// share most of the work.
+class BitBfs {
+ public:
+  static constexpr unsigned unreachable = std::numeric_limits<unsigned>::max();
+
+ protected:
+  // Row pitch is nwords + 1 (guard word).
+  unsigned rows, stride, nwords, pitch;
+  std::vector<uint64_t> open, visited, frontier, next;
+  // Non-empty frontier rows in increasing order.
+  std::vector<unsigned> active, next_active;
+  // Rows next to frontier, mark is set while row is in candidates.
+  std::vector<unsigned> candidates;
+  std::vector<char> mark;
+  unsigned layer = 0;
+  // RunBatch, by cell: all bits for walls (so they are never reached),
+  // sources that reached cell so far and at current and next layer. Cells
+  // of current and next layer.
+  std::vector<uint64_t> walls, seen, reached, reached_next;
+  std::vector<unsigned> cells, cells_next;
+
+  uint64_t& Word(std::vector<uint64_t>& v, unsigned c) const {
+    return v[(c / stride) * pitch + (c % stride) / 64];
+  }
+
+  static uint64_t Bit(unsigned col) { return uint64_t(1) << (col % 64); }
+
+  void Start(const std::vector<unsigned>& sources) {
+    std::fill(visited.begin(), visited.end(), 0);
+    for (auto r : active) std::fill_n(&frontier[r * pitch], nwords, 0);
+    active.clear();
+    layer = 0;
+    for (auto c : sources) {
+      auto bit = Bit(c % stride);
+      if (!(Word(open, c) & bit)) continue;
+      Word(frontier, c) |= bit;
+      Word(visited, c) |= bit;
+      active.push_back(c / stride);
+    }
+    std::sort(active.begin(), active.end());
+    active.erase(std::unique(active.begin(), active.end()), active.end());
+  }
+
+  // Next layer into frontier, returns false if it is empty.
+  bool Step() {
+    if (active.empty()) return false;
+    // Border rows are walls, frontier is within [1, rows - 2]. Candidates
+    // stay sorted as active rows are.
+    candidates.clear();
+    for (auto r : active) {
+      for (unsigned r1 = std::max(r - 1, 1u); r1 <= std::min(r + 1, rows - 2);
+           ++r1) {
+        if (mark[r1]) continue;
+        mark[r1] = 1;
+        candidates.push_back(r1);
+      }
+    }
+    next_active.clear();
+    for (auto r : candidates) {
+      mark[r] = 0;
+      const uint64_t* up = &frontier[(r - 1) * pitch];
+      const uint64_t* f = up + pitch;
+      const uint64_t* down = f + pitch;
+      uint64_t any = 0;
+      for (int k = 0; k < int(nwords); ++k) {
+        uint64_t x = (f[k] << 1) | (f[k - 1] >> 63) | (f[k] >> 1) |
+                     (f[k + 1] << 63) | up[k] | down[k];
+        auto i = r * pitch + k;
+        x &= open[i] & ~visited[i];
+        next[i] = x;
+        visited[i] |= x;
+        any |= x;
+      }
+      if (any) next_active.push_back(r);
+    }
+    // Clear old layer, next is all zero after swap.
+    for (auto r : active) std::fill_n(&frontier[r * pitch], nwords, 0);
+    frontier.swap(next);
+    active.swap(next_active);
+    ++layer;
+    return !active.empty();
+  }
+
+  // Calls f(cell) for every cell of frontier.
+  template <class TCallback>
+  void ForEachFrontierCell(TCallback& f) const {
+    for (auto r : active) {
+      for (unsigned k = 0; k < nwords; ++k) {
+        for (uint64_t x = frontier[r * pitch + k]; x; x &= x - 1)
+          f(r * stride + k * 64 + __builtin_ctzll(x));
+      }
+    }
+  }
+
+ public:
+  explicit BitBfs(const Maze& maze)
+      : rows(maze.Height() + 2),
+        stride(maze.Stride()),
+        nwords((maze.Stride() + 63) / 64),
+        pitch(nwords + 1),
+        open(rows * pitch, 0),
+        visited(open.size(), 0),
+        frontier(open.size(), 0),
+        next(open.size(), 0),
+        mark(rows, 0) {
+    for (unsigned c = 0; c < maze.Size(); ++c) {
+      if (!maze.Wall(c)) Word(open, c) |= Bit(c % stride);
+    }
+  }
+
+  // Bit mask of cells in the same layout, for CountWithin.
+  std::vector<uint64_t> Mask(const std::vector<unsigned>& cells) const {
+    std::vector<uint64_t> mask(open.size(), 0);
+    for (auto c : cells) Word(mask, c) |= Bit(c % stride);
+    return mask;
+  }
+
+  // Calls f(cell, distance) for every cell within max_distance of the
+  // nearest source in order of distance, returns the largest distance.
+  template <class TCallback>
+  unsigned Run(const std::vector<unsigned>& sources, unsigned max_distance,
+               TCallback f) {
+    Start(sources);
+    for (;;) {
+      auto g = [&](unsigned c) { f(c, layer); };
+      ForEachFrontierCell(g);
+      if ((layer >= max_distance) || !Step()) break;
+    }
+    return !active.empty() ? layer : layer - 1;
+  }
+
+  // Calls f(cell, distance, bits) for every reachable cell and distance to
+  // it from some of sources (at most 64), bit k of bits is set if distance
+  // from sources[k] is that.
+  template <class TCallback>
+  void RunBatch(const std::vector<unsigned>& sources, TCallback f) {
+    assert(sources.size() <= 64);
+    unsigned size = rows * stride;
+    if (walls.empty()) {
+      walls.assign(size, ~uint64_t(0));
+      for (unsigned c = 0; c < size; ++c) {
+        if (Word(open, c) & Bit(c % stride)) walls[c] = 0;
+      }
+      reached.assign(size, 0);
+      reached_next.assign(size, 0);
+    }
+    seen = walls;
+    cells.clear();
+    for (unsigned k = 0; k < sources.size(); ++k) {
+      auto c = sources[k];
+      if (walls[c]) continue;
+      if (!reached[c]) cells.push_back(c);
+      reached[c] |= uint64_t(1) << k;
+      seen[c] |= uint64_t(1) << k;
+    }
+    const int delta[4] = {1, int(stride), -1, -int(stride)};
+    for (unsigned d = 0; !cells.empty(); ++d) {
+      cells_next.clear();
+      for (auto c : cells) {
+        auto bits = reached[c];
+        reached[c] = 0;
+        f(c, d, bits);
+        for (auto dc : delta) {
+          unsigned c1 = c + dc;
+          auto x = bits & ~seen[c1];
+          if (!x) continue;
+          if (!reached_next[c1]) cells_next.push_back(c1);
+          reached_next[c1] |= x;
+          seen[c1] |= x;
+        }
+      }
+      cells.swap(cells_next);
+      reached.swap(reached_next);
+    }
+  }
+
+  // Distances to the nearest of sources, unreachable for other cells.
+  void Distances(const std::vector<unsigned>& sources,
+                 std::vector<unsigned>& distance,
+                 unsigned max_distance = unreachable) {
+    distance.assign(rows * stride, unreachable);
+    Run(sources, max_distance, [&](unsigned c, unsigned d) { distance[c] = d; });
+  }
+
+  // Number of cells of mask within max_distance of the nearest source.
+  unsigned CountWithin(const std::vector<unsigned>& sources,
+                       unsigned max_distance,
+                       const std::vector<uint64_t>& mask) {
+    Start(sources);
+    for (unsigned d = 0; d < max_distance && Step(); ++d) {
+    }
+    unsigned count = 0;
+    for (size_t i = 0; i < mask.size(); ++i)
+      count += __builtin_popcountll(visited[i] & mask[i]);
+    return count;
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "lambdaman/maze.h"
+#include "lambdaman/utils/bfs.h"
+#include "lambdaman/utils/bit_bfs.h"
+
+#include "common/base.h"
+#include "common/thread_pool.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace lambdaman {
+// Pills grouped into clusters: connected components of pills inside
+// block x block tiles. Clusters are far fewer than pills, so all-pairs
+// distances between them (between first cells, BitBfs batches of 64
+// clusters) are cheap to store.
+class PillClusters {
+ public:
+  static constexpr unsigned none = Bfs::unreachable;
+
+ protected:
+  std::vector<unsigned> cluster;  // By cell, none for cells without pill.
+  std::vector<std::vector<unsigned>> cells;
+  std::vector<unsigned> distances;  // Size() x Size()
+
+ public:
+  void Build(const Maze& maze, const std::vector<unsigned>& pills,
+             unsigned block) {
+    cluster.assign(maze.Size(), none);
+    cells.clear();
+    distances.clear();
+    std::vector<char> pill(maze.Size(), 0);
+    for (auto c : pills) pill[c] = 1;
+    auto tile = [&](unsigned c) {
+      return std::make_pair(maze.PRow(c) / block, maze.PCol(c) / block);
+    };
+    std::vector<unsigned> stack;
+    for (auto c0 : pills) {
+      if (cluster[c0] != none) continue;
+      unsigned id = cells.size();
+      cells.emplace_back();
+      cluster[c0] = id;
+      stack.push_back(c0);
+      for (; !stack.empty();) {
+        auto c = stack.back();
+        stack.pop_back();
+        cells[id].push_back(c);
+        for (unsigned d = 0; d < 4; ++d) {
+          auto c1 = maze.Next(c, d);
+          if (pill[c1] && (cluster[c1] == none) && (tile(c1) == tile(c0))) {
+            cluster[c1] = id;
+            stack.push_back(c1);
+          }
+        }
+      }
+    }
+  }
+
+  unsigned Size() const { return cells.size(); }
+  unsigned Cluster(unsigned cell) const { return cluster[cell]; }
+  const std::vector<unsigned>& Cells(unsigned i) const { return cells[i]; }
+  unsigned Representative(unsigned i) const { return cells[i][0]; }
+
+  // All-pairs distances between representatives, batches of rows in
+  // parallel. Clusters are numbered in pill order, so clusters of batch are
+  // close to each other.
+  void ComputeDistances(const Maze& maze, unsigned nthreads = 1) {
+    unsigned n = Size();
+    distances.assign(size_t(n) * n, none);
+    std::vector<unsigned> index(maze.Size(), none);
+    for (unsigned j = 0; j < n; ++j) index[Representative(j)] = j;
+    unsigned nblocks = std::max(nthreads, 1u);
+    {
+      ThreadPool tp(nblocks);
+      for (unsigned b = 0; b < nblocks; ++b) {
+        auto t = std::make_shared<std::packaged_task<void()>>([&, b]() {
+          BitBfs bfs(maze);
+          std::vector<unsigned> sources;
+          for (unsigned i0 = 64 * b; i0 < n; i0 += 64 * nblocks) {
+            sources.clear();
+            for (unsigned i = i0; i < std::min(i0 + 64, n); ++i)
+              sources.push_back(Representative(i));
+            bfs.RunBatch(sources, [&](unsigned c, unsigned d, uint64_t bits) {
+              auto j = index[c];
+              if (j == none) return;
+              // Moves are reversible, so distances are symmetric and row of
+              // j is written close together.
+              auto row = &distances[size_t(j) * n + i0];
+              for (; bits; bits &= bits - 1) row[__builtin_ctzll(bits)] = d;
+            });
+          }
+        });
+        tp.EnqueueTask(std::move(t));
+      }
+    }
+  }
+
+  unsigned Distance(unsigned i, unsigned j) const {
+    return distances[size_t(i) * Size() + j];
+  }
+};
+}  // namespace lambdaman
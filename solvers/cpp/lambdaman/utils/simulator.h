@@ -0,0 +1,51 @@
+#pragma once
+
+#include "lambdaman/maze.h"
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace lambdaman {
+// Replays moves on maze. Eaten cells are stamped with run number, so
+// repeated runs on the same maze don't clear arrays.
+class Simulator {
+ protected:
+  const Maze& maze;
+  std::vector<unsigned> stamp;
+  unsigned epoch = 0;
+  unsigned total_pills = 0;
+  int direction[256];
+
+ public:
+  explicit Simulator(const Maze& _maze)
+      : maze(_maze), stamp(maze.Size(), 0) {
+    for (unsigned c = 0; c < maze.Size(); ++c) total_pills += maze.Pill(c);
+    for (auto& d : direction) d = -1;
+    for (unsigned d = 0; d < 4; ++d)
+      direction[static_cast<unsigned char>(directions[d])] = d;
+  }
+
+  // Pills left after moves, -1 if moves contain other characters.
+  int64_t PillsLeft(std::string_view moves) {
+    if (++epoch == 0) {
+      std::fill(stamp.begin(), stamp.end(), 0u);
+      epoch = 1;
+    }
+    int64_t left = total_pills;
+    unsigned pos = maze.Start();
+    for (char c : moves) {
+      int d = direction[static_cast<unsigned char>(c)];
+      if (d < 0) return -1;
+      pos = maze.Next(pos, d);
+      if (maze.Pill(pos) && (stamp[pos] != epoch)) {
+        stamp[pos] = epoch;
+        --left;
+      }
+    }
+    return left;
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "lambdaman/maze.h"
+#include "lambdaman/utils/bfs.h"
+
+#include "common/base.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace lambdaman {
+// Walk under construction: position, eaten pills and moves so far. Paths
+// are shortest ones from Bfs, pills on the way are eaten too.
+class Walker {
+ protected:
+  const Maze& maze;
+  Bfs bfs;
+  std::vector<char> eaten;
+  unsigned pos;
+  unsigned pills_left = 0;
+  std::string moves;
+  std::vector<unsigned> path;  // Directions
+
+  void Eat(unsigned c) {
+    if (maze.Pill(c) && !eaten[c]) {
+      eaten[c] = 1;
+      --pills_left;
+    }
+  }
+
+  // Moves of last bfs run from pos to reached cell to.
+  void BuildPath(unsigned to) {
+    path.clear();
+    for (unsigned c = to; bfs.Distance(c) > 0;) {
+      for (unsigned d = 0; d < 4; ++d) {
+        auto p = maze.Next(c, d);
+        if ((p != c) && (bfs.Distance(p) + 1 == bfs.Distance(c))) {
+          path.push_back((d + 2) % 4);
+          c = p;
+          break;
+        }
+      }
+    }
+    std::reverse(path.begin(), path.end());
+  }
+
+  void FollowPath() {
+    for (auto d : path) Move(d);
+  }
+
+ public:
+  explicit Walker(const Maze& _maze)
+      : maze(_maze), bfs(maze), eaten(maze.Size(), 0), pos(maze.Start()) {
+    for (unsigned c = 0; c < maze.Size(); ++c) pills_left += maze.Pill(c);
+  }
+
+  unsigned Position() const { return pos; }
+  unsigned PillsLeft() const { return pills_left; }
+  bool Eaten(unsigned c) const { return eaten[c]; }
+  const std::string& Moves() const { return moves; }
+
+  void Move(unsigned d) {
+    pos = maze.Next(pos, d);
+    moves += directions[d];
+    Eat(pos);
+  }
+
+  // Goes to the nearest uneaten pill with pred(cell), returns false if there
+  // is none reachable.
+  template <class TPred>
+  bool GoToNearest(TPred pred) {
+    auto r = bfs.Nearest(pos, [&](unsigned c) {
+      return maze.Pill(c) && !eaten[c] && pred(c);
+    });
+    if (r.first == Bfs::unreachable) return false;
+    BuildPath(r.first);
+    FollowPath();
+    return true;
+  }
+
+  bool GoToNearestPill() {
+    return GoToNearest([](unsigned) { return true; });
+  }
+};
+}  // namespace lambdaman
@@ -0,0 +1,1027 @@
+#include "common/files/command_line.h"
+#include "common/string/utils/split.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <limits>
+#include <bitset>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Lehmer generator of the walk, state starts at the seed itself.
+class Rng {
+private:
+    long long seed;
+
+public:
+    static const long long multiplier = 48271;
+    static const long long modulus = (1LL << 31) - 1;
+
+    Rng(long long seed) : seed(seed) {}
+
+    int next() {
+        int ret = seed;
+        seed = (seed * multiplier) % modulus;
+        // seed = (seed * 3) % ((1LL << 17) - 1);
+        return ret;
+    }
+};
+
+// Up to 256 x 256 maze with one cell wall border on every side.
+const int max_padded_size = (256 + 2) * (256 + 2);
+const int dx[] = {0, 1, 0, -1};
+const int dy[] = {1, 0, -1, 0};
+
+// Maze as flat byte grid (row-major, padded with walls), cells are
+// addressed by index. next[4 * cell + d] is the cell after move in direction
+// d, the cell itself if move is blocked by wall, so simulation doesn't need
+// bounds checks.
+struct Grid {
+    int rows, cols, stride;
+    std::vector<char> cells;
+    std::vector<int> next;
+    int start;
+
+    Grid(std::vector<std::string> const& maze)
+            : rows(maze.size()), cols(maze.empty() ? 0 : maze[0].size()),
+              stride(cols + 2), cells((rows + 2) * stride, '#'), start(-1) {
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols && j < int(maze[i].size()); ++j) {
+                cells[index(i, j)] = maze[i][j];
+                if (maze[i][j] == 'L') {
+                    start = index(i, j);
+                }
+            }
+        }
+        const int delta[] = {1, stride, -1, -stride};
+        next.resize(4 * cells.size());
+        for (int c = 0; c < int(cells.size()); ++c) {
+            for (int d = 0; d < 4; ++d) {
+                int c1 = c + delta[d];
+                bool open = cells[c] != '#' && c1 >= 0 && c1 < int(cells.size()) &&
+                            cells[c1] != '#';
+                next[4 * c + d] = open ? c1 : c;
+            }
+        }
+    }
+
+    int index(int x, int y) const { return (x + 1) * stride + (y + 1); }
+    int row(int c) const { return c / stride - 1; }
+    int col(int c) const { return c % stride - 1; }
+};
+
+// Random walk of seed from pos, returns number of steps. state.visit(c)
+// marks cell and returns true if it was not visited before, walk stops early
+// if state.keep_going(steps) returns false.
+template <class State>
+int walk(Grid const& grid, int seed, int max_steps, int& pos, int& n_unvisited,
+         int& last_unvisited, State& state) {
+    Rng rng(seed);
+    int d = 0;
+    int steps = 0;
+    const int* next = grid.next.data();
+
+    while (n_unvisited > 0 && (max_steps == -1 || steps < max_steps) &&
+           state.keep_going(steps)) {
+        ++steps;
+
+        // Current cell is always visited, so blocked move changes nothing.
+        pos = next[4 * pos + d];
+        if (state.visit(pos)) {
+            --n_unvisited;
+            last_unvisited = pos;
+        }
+
+        d = (d + rng.next() % 3 + 3) % 4;
+    }
+    return steps;
+}
+
+struct MazeState {
+    Grid const& grid;
+    // Current cell, -1 if there is no 'L' in the maze.
+    int pos;
+    std::bitset<max_padded_size> visited;
+    // Cell eaten last, -1 if none.
+    int last_unvisited;
+    int n_unvisited;
+
+    std::vector<std::pair<int, int>> seeds_steps;
+
+    MazeState(Grid const& grid)
+            : grid(grid), pos(grid.start), last_unvisited(-1), n_unvisited(0) {
+        for (size_t c = 0; c < grid.cells.size(); ++c) {
+            if (grid.cells[c] == '.') {
+                ++n_unvisited;
+            }
+        }
+        if (pos >= 0) {
+            visited[pos] = true;
+        }
+    }
+
+    MazeState(MazeState const& other)
+            : grid(other.grid),
+              pos(other.pos),
+              visited(other.visited),
+              last_unvisited(other.last_unvisited),
+              n_unvisited(other.n_unvisited),
+              seeds_steps(other.seeds_steps) {}
+
+    bool visit(int c) {
+        if (visited[c]) {
+            return false;
+        }
+        visited[c] = true;
+        return true;
+    }
+
+    bool keep_going(int) const { return true; }
+
+    void simulate(int seed, int max_steps) {
+        int steps = walk(grid, seed, max_steps, pos, n_unvisited,
+                         last_unvisited, *this);
+        seeds_steps.emplace_back(seed, steps);
+    }
+
+};
+
+// Candidate for the best seed, ties go to the smaller seed so the result
+// doesn't depend on the number of threads or shards.
+struct SeedScore {
+    int seed = -1;
+    long long gain1 = 0, gain2 = 0;
+    double score = -1, score1 = 0, score2 = 0;
+
+    // Scores are non-negative or NaN (nothing left to eat), NaN never wins.
+    bool better(SeedScore const& other) const {
+        return score > other.score ||
+               (score == other.score && seed < other.seed);
+    }
+};
+
+// Scores of walks from root for one split. score1 -- stats count of visited
+// cells, score2 -- number of pills eaten by the walk. Both are sums of integer
+// weights of cells the walk eats (plus constant for cells visited in root),
+// so they are accumulated during simulation.
+struct SeedScorer {
+    std::vector<std::pair<int, int>> weights;
+    long long base_score1;
+    double total_score1, total_score2;
+    // top1[n] -- sum of n largest gain1 weights, total_gain2 -- pills left.
+    std::vector<long long> top1;
+    long long total_gain2;
+
+    SeedScorer(const MazeState& root_state, const std::vector<int>& stats)
+            : weights(root_state.grid.cells.size(), {0, 0}), base_score1(0),
+              total_score1(0), total_score2(0), total_gain2(0) {
+        const Grid& grid = root_state.grid;
+        for (size_t c = 0; c < stats.size(); ++c) {
+            total_score1 += stats[c];
+            if (root_state.visited[c]) {
+                base_score1 += stats[c];
+            } else {
+                weights[c].first += stats[c];
+            }
+        }
+        for (size_t c = 0; c < grid.cells.size(); ++c) {
+            if (grid.cells[c] == '.' && !root_state.visited[c]) {
+                total_score2 += 1;
+                weights[c].second = 1;
+            }
+        }
+        total_gain2 = total_score2;
+        std::vector<int> w1;
+        for (auto& w : weights) {
+            if (w.first > 0) {
+                w1.push_back(w.first);
+            }
+        }
+        std::sort(w1.rbegin(), w1.rend());
+        top1.assign(1, 0);
+        for (int w : w1) {
+            top1.push_back(top1.back() + w);
+        }
+    }
+
+    SeedScore score(int seed, long long gain1, long long gain2) const {
+        SeedScore r;
+        r.seed = seed;
+        r.gain1 = gain1;
+        r.gain2 = gain2;
+        r.score1 = (base_score1 + gain1) / total_score1;
+        r.score2 = gain2 / total_score2;
+        r.score = r.score1 + r.score2;
+        return r;
+    }
+
+    // Upper bound of score of walk with current gains after steps_left more
+    // steps: every step eats at most one cell. Computed by score() itself,
+    // so it is never below the final score in floating point either.
+    SeedScore bound(int seed, long long gain1, long long gain2, long long steps_left) const {
+        long long n = std::min<long long>(steps_left, top1.size() - 1);
+        return score(seed, std::min(top1.back(), gain1 + top1[n]),
+                     std::min(total_gain2, gain2 + steps_left));
+    }
+};
+
+// Walks of seed search are checked against the best seed so far every
+// period steps and abandoned once they can't beat it even in the best case.
+// The result of the search doesn't change.
+struct Cutoff {
+    static const int period = 1024;
+
+    SeedScorer const& scorer;
+    SeedScore const& best;
+
+    bool hopeless(int seed, long long gain1, long long gain2, int steps_left) const {
+        return !scorer.bound(seed, gain1, gain2, steps_left).better(best);
+    }
+};
+
+
+// Walk on top of read-only root state, one per thread. Cells visited in
+// root are stamped with max value, cells visited by current walk with
+// epoch, so next walk starts in O(1) and costs only the steps it takes.
+struct WalkOverlay {
+    MazeState const& root;
+    std::vector<unsigned> stamp;
+    unsigned epoch;
+    int pos, last_unvisited, n_unvisited;
+    // Optional per-cell weights (gain1, gain2) summed over cells eaten by
+    // current walk.
+    std::vector<std::pair<int, int>> const* weights;
+    long long gain1, gain2;
+    // Optional early abort of current walk (needs weights and max_steps).
+    Cutoff const* cutoff;
+    int seed, max_steps;
+    bool aborted;
+
+    WalkOverlay(MazeState const& root,
+                std::vector<std::pair<int, int>> const* weights = nullptr,
+                Cutoff const* cutoff = nullptr)
+            : root(root), stamp(root.grid.cells.size()), epoch(0),
+              weights(weights), gain1(0), gain2(0), cutoff(cutoff), seed(0),
+              max_steps(-1), aborted(false) {
+        reset_stamps();
+    }
+
+    void reset_stamps() {
+        for (size_t c = 0; c < stamp.size(); ++c) {
+            stamp[c] = root.visited[c] ? std::numeric_limits<unsigned>::max() : 0;
+        }
+        epoch = 0;
+    }
+
+    bool visited(int c) const { return stamp[c] >= epoch; }
+
+    bool visit(int c) {
+        if (stamp[c] >= epoch) {
+            return false;
+        }
+        stamp[c] = epoch;
+        if (weights) {
+            gain1 += (*weights)[c].first;
+            gain2 += (*weights)[c].second;
+        }
+        return true;
+    }
+
+    bool keep_going(int steps) {
+        if (!cutoff || max_steps == -1 || (steps & (Cutoff::period - 1))) {
+            return true;
+        }
+        aborted = cutoff->hopeless(seed, gain1, gain2, max_steps - steps);
+        return !aborted;
+    }
+
+    void simulate(int seed, int max_steps) {
+        if (++epoch == std::numeric_limits<unsigned>::max()) {
+            reset_stamps();
+            epoch = 1;
+        }
+        this->seed = seed;
+        this->max_steps = max_steps;
+        aborted = false;
+        pos = root.pos;
+        last_unvisited = root.last_unvisited;
+        n_unvisited = root.n_unvisited;
+        gain1 = gain2 = 0;
+        walk(root.grid, seed, max_steps, pos, n_unvisited, last_unvisited,
+             *this);
+    }
+};
+
+#ifdef __AVX2__
+// Eight walks from root state in lock-step, one per AVX2 lane: Lehmer step
+// and mod 3 through 32x32->64 multiplies, moves and visited test through
+// gathers. Lane l of cell c is stamped in stamp[lanes * c + l], newly eaten
+// cells (rare compared to steps) are processed per lane. Results for every
+// seed are the same as from WalkOverlay::simulate.
+struct WalkOverlay8 {
+    static const int lanes = 8;
+
+    MazeState const& root;
+    std::vector<unsigned> stamp;
+    unsigned epoch;
+    std::vector<std::pair<int, int>> const* weights;
+    Cutoff const* cutoff;
+    int pos[lanes], last_unvisited[lanes], n_unvisited[lanes], steps[lanes];
+    long long gain1[lanes], gain2[lanes];
+    bool aborted[lanes];
+
+    WalkOverlay8(MazeState const& root,
+                 std::vector<std::pair<int, int>> const* weights = nullptr,
+                 Cutoff const* cutoff = nullptr)
+            : root(root), stamp(lanes * root.grid.cells.size()), epoch(0),
+              weights(weights), cutoff(cutoff) {
+        reset_stamps();
+    }
+
+    void reset_stamps() {
+        for (size_t c = 0; c < root.grid.cells.size(); ++c) {
+            for (int l = 0; l < lanes; ++l) {
+                stamp[lanes * c + l] = root.visited[c] ? std::numeric_limits<unsigned>::max() : 0;
+            }
+        }
+        epoch = 0;
+    }
+
+    // (x * y) for unsigned 32-bit lanes as two vectors of 64-bit products:
+    // even lanes and odd lanes.
+    static void mul_wide(__m256i x, __m256i y, __m256i& even, __m256i& odd) {
+        even = _mm256_mul_epu32(x, y);
+        odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), y);
+    }
+
+    // Low 32 bits of 64-bit lanes back to 32-bit lanes.
+    static __m256i pack(__m256i even, __m256i odd) {
+        return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    }
+
+    // Next state of Rng for lanes in [0, 2^31 - 1).
+    static __m256i lehmer_next(__m256i x) {
+        const __m256i a = _mm256_set1_epi64x(Rng::multiplier);
+        const __m256i m = _mm256_set1_epi64x(Rng::modulus);
+        __m256i even, odd;
+        mul_wide(x, a, even, odd);
+        // p mod (2^31 - 1) = (p & m) + (p >> 31), at most one subtraction.
+        even = _mm256_add_epi64(_mm256_and_si256(even, m), _mm256_srli_epi64(even, 31));
+        odd = _mm256_add_epi64(_mm256_and_si256(odd, m), _mm256_srli_epi64(odd, 31));
+        __m256i r = pack(even, odd);
+        const __m256i m32 = _mm256_set1_epi32(Rng::modulus);
+        __m256i ge = _mm256_cmpeq_epi32(_mm256_max_epu32(r, m32), r);
+        return _mm256_sub_epi32(r, _mm256_and_si256(ge, m32));
+    }
+
+    // x mod 3 for lanes in [0, 2^31), x / 3 = (x * 0xAAAAAAAB) >> 33.
+    static __m256i mod3(__m256i x) {
+        __m256i even, odd;
+        mul_wide(x, _mm256_set1_epi32(0xAAAAAAAB), even, odd);
+        __m256i q = pack(_mm256_srli_epi64(even, 33), _mm256_srli_epi64(odd, 33));
+        __m256i q3 = _mm256_add_epi32(q, _mm256_add_epi32(q, q));
+        return _mm256_sub_epi32(x, q3);
+    }
+
+    // Simulates seeds[0..n), n <= lanes, max_steps == -1 - no limit.
+    void simulate(const int* seeds, int n, int max_steps) {
+        if (++epoch == std::numeric_limits<unsigned>::max()) {
+            reset_stamps();
+            epoch = 1;
+        }
+        int limit = max_steps == -1 ? std::numeric_limits<int>::max() : max_steps;
+        int seeds_all[lanes];
+        for (int l = 0; l < lanes; ++l) {
+            seeds_all[l] = l < n ? seeds[l] : 1;
+            pos[l] = root.pos;
+            last_unvisited[l] = root.last_unvisited;
+            n_unvisited[l] = root.n_unvisited;
+            steps[l] = 0;
+            gain1[l] = gain2[l] = 0;
+            aborted[l] = false;
+        }
+        const int* next = root.grid.next.data();
+        const int* vstamp = reinterpret_cast<const int*>(stamp.data());
+        const __m256i lane_ids = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i vepoch = _mm256_set1_epi32(epoch);
+        const __m256i vlimit = _mm256_set1_epi32(limit);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i three = _mm256_set1_epi32(3);
+        __m256i vseed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(seeds_all));
+        __m256i vpos = _mm256_set1_epi32(root.pos);
+        __m256i vnun = _mm256_set1_epi32(root.n_unvisited);
+        __m256i vd = zero;
+        __m256i vsteps = zero;
+        __m256i active = _mm256_cmpgt_epi32(_mm256_set1_epi32(n), lane_ids);
+        auto update_active = [&]() {
+            active = _mm256_and_si256(active, _mm256_cmpgt_epi32(vnun, zero));
+            active = _mm256_and_si256(active, _mm256_cmpgt_epi32(vlimit, vsteps));
+        };
+        update_active();
+        // Lanes step together, so all active lanes have made iteration steps.
+        bool check = cutoff && max_steps != -1;
+        const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+
+        for (int iteration = 0; !_mm256_testz_si256(active, active); ++iteration) {
+            if (check && iteration && !(iteration & (Cutoff::period - 1))) {
+                int killed = 0;
+                for (int mask = _mm256_movemask_ps(_mm256_castsi256_ps(active)); mask; mask &= mask - 1) {
+                    int l = __builtin_ctz(mask);
+                    if (cutoff->hopeless(seeds_all[l], gain1[l], gain2[l], limit - iteration)) {
+                        aborted[l] = true;
+                        killed |= 1 << l;
+                    }
+                }
+                if (killed) {
+                    __m256i vkilled = _mm256_and_si256(_mm256_set1_epi32(killed), lane_bits);
+                    active = _mm256_andnot_si256(_mm256_cmpgt_epi32(vkilled, zero), active);
+                    if (_mm256_testz_si256(active, active)) {
+                        break;
+                    }
+                }
+            }
+            vsteps = _mm256_sub_epi32(vsteps, active);
+
+            __m256i index = _mm256_add_epi32(_mm256_slli_epi32(vpos, 2), vd);
+            __m256i vnext = _mm256_i32gather_epi32(next, index, 4);
+            vpos = _mm256_blendv_epi8(vpos, vnext, active);
+
+            __m256i sindex = _mm256_add_epi32(_mm256_slli_epi32(vpos, 3), lane_ids);
+            __m256i vst = _mm256_i32gather_epi32(vstamp, sindex, 4);
+            // Unsigned stamp < epoch.
+            __m256i seen = _mm256_cmpeq_epi32(_mm256_max_epu32(vst, vepoch), vst);
+            __m256i fresh = _mm256_andnot_si256(seen, active);
+            int mask = _mm256_movemask_ps(_mm256_castsi256_ps(fresh));
+            if (mask) {
+                alignas(32) int p[lanes];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(p), vpos);
+                for (; mask; mask &= mask - 1) {
+                    int l = __builtin_ctz(mask);
+                    int c = p[l];
+                    stamp[lanes * c + l] = epoch;
+                    last_unvisited[l] = c;
+                    if (weights) {
+                        gain1[l] += (*weights)[c].first;
+                        gain2[l] += (*weights)[c].second;
+                    }
+                }
+                vnun = _mm256_add_epi32(vnun, fresh);
+            }
+
+            // d = (d + rng.next() % 3 + 3) % 4
+            vd = _mm256_add_epi32(vd, _mm256_add_epi32(mod3(vseed), three));
+            vd = _mm256_and_si256(vd, three);
+            vseed = lehmer_next(vseed);
+
+            update_active();
+        }
+
+        alignas(32) int buffer[lanes];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(buffer), vpos);
+        std::copy(buffer, buffer + lanes, pos);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(buffer), vnun);
+        std::copy(buffer, buffer + lanes, n_unvisited);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(buffer), vsteps);
+        std::copy(buffer, buffer + lanes, steps);
+    }
+};
+#endif
+
+// Number of random walks that ate the last pill in cell (dense, indexed by
+// cell). Walks that ate nothing are counted in cell 0, it is a border wall
+// and can't be visited.
+std::vector<int> compute_stats(const MazeState& state, int iters) {
+    std::vector<int> stats(state.grid.cells.size(), 0);
+    #pragma omp parallel
+    {
+        WalkOverlay overlay(state);
+        std::vector<int> local_stats(stats.size(), 0);
+        // Walks until the last pill have very different lengths.
+        #pragma omp for schedule(dynamic) nowait
+        for (int i = 1; i <= iters; ++i) {
+            overlay.simulate(i, -1);
+            local_stats[std::max(overlay.last_unvisited, 0)]++;
+        }
+
+        #pragma omp critical
+        {
+            for (size_t c = 0; c < stats.size(); ++c) {
+                stats[c] += local_stats[c];
+            }
+        }
+    }
+
+    return stats;
+}
+
+// Best of seeds [first_seed, last_seed].
+SeedScore find_best_seed(const MazeState& root_state, int sim_iters, int first_seed, int last_seed, const SeedScorer& scorer) {
+    SeedScore best;
+    int n_seeds = last_seed - first_seed + 1;
+
+    #pragma omp parallel
+    {
+        SeedScore local_best;
+        Cutoff cutoff{scorer, local_best};
+        auto add_candidate = [&](int seed, long long gain1, long long gain2) {
+            SeedScore candidate = scorer.score(seed, gain1, gain2);
+            if (candidate.better(local_best)) {
+                local_best = candidate;
+            }
+        };
+#ifdef __AVX2__
+        const int lanes = WalkOverlay8::lanes;
+        WalkOverlay8 state(root_state, &scorer.weights, &cutoff);
+        #pragma omp for nowait
+        for (int b = 0; b < (n_seeds + lanes - 1) / lanes; ++b) {
+            int seeds[lanes];
+            int n = std::min(lanes, n_seeds - b * lanes);
+            for (int l = 0; l < n; ++l) {
+                seeds[l] = first_seed + b * lanes + l;
+            }
+            state.simulate(seeds, n, sim_iters);
+            for (int l = 0; l < n; ++l) {
+                if (!state.aborted[l]) {
+                    add_candidate(seeds[l], state.gain1[l], state.gain2[l]);
+                }
+            }
+        }
+#else
+        WalkOverlay state(root_state, &scorer.weights, &cutoff);
+        #pragma omp for nowait
+        for (int i = 0; i < n_seeds; ++i) {
+            state.simulate(first_seed + i, sim_iters);
+            if (!state.aborted) {
+                add_candidate(first_seed + i, state.gain1, state.gain2);
+            }
+        }
+#endif
+
+        #pragma omp critical
+        {
+            if (local_best.better(best)) {
+                best = local_best;
+            }
+        }
+    }
+
+    return best;
+}
+
+// Seed search of every split divided into shards of seeds. Worker processes
+// (on this machine or others sharing the directory) claim shards through
+// lock files and store the best seed of shard in file, so finished shards
+// are not recomputed after restart. Stats of split are stored by the first
+// worker, every worker merges shard results itself. Layout:
+//   <dir>/split<k>/stats.txt, shard<j>.txt, shard<j>.lock
+// Stats and shard files start with the header of split: search parameters
+// and "seed steps" of splits chosen before it, files of other runs (or
+// unreadable ones) are renamed to *.stale and computed again.
+// Shards split the seed space, not one random stream: every seed is its own
+// walk with Rng starting at the seed, so shard j is seeds
+// [1 + j * shard_size, (j + 1) * shard_size] and no Rng jump-ahead is needed.
+struct ShardedSearch {
+    // Holder of lock touches it every lease_period seconds, lock that was
+    // not touched for lease_timeout seconds is stale.
+    static const int lease_period = 10;
+    static const int lease_timeout = 60;
+
+    std::string dir;
+    std::string params;
+    int shard_size;
+
+    ShardedSearch(std::string const& dir, std::string const& params, int shard_size)
+            : dir(dir), params(params + " " + std::to_string(shard_size)),
+              shard_size(shard_size) {}
+
+    std::string split_dir(int split) const {
+        return dir + "/split" + std::to_string(split);
+    }
+
+    std::string shard_file(int split, int shard) const {
+        return split_dir(split) + "/shard" + std::to_string(shard) + ".txt";
+    }
+
+    std::string lock_file(int split, int shard) const {
+        return split_dir(split) + "/shard" + std::to_string(shard) + ".lock";
+    }
+
+    std::string header(const MazeState& root_state) const {
+        std::string h = params;
+        for (auto& [seed, steps] : root_state.seeds_steps) {
+            h += " " + std::to_string(seed) + " " + std::to_string(steps);
+        }
+        return h;
+    }
+
+    // False if file can't be read or was made by other run.
+    static bool check_header(std::ifstream& f, std::string const& expected) {
+        std::string h;
+        return std::getline(f, h) && h == expected;
+    }
+
+    // Moves file out of the way, so it is computed again.
+    static void discard(std::string const& filename) {
+        std::cerr << filename << " doesn't match this run, starting it fresh" << std::endl;
+        std::rename(filename.c_str(), (filename + ".stale").c_str());
+    }
+
+    static std::string host() {
+        char buffer[256] = {};
+        gethostname(buffer, sizeof(buffer) - 1);
+        return buffer;
+    }
+
+    // Readers never see partially written file.
+    static bool write_atomic(std::string const& filename, std::string const& content) {
+        std::string tmp = filename + ".tmp" + std::to_string(getpid());
+        {
+            std::ofstream f(tmp);
+            if (!(f << content)) {
+                return false;
+            }
+        }
+        return std::rename(tmp.c_str(), filename.c_str()) == 0;
+    }
+
+    // Lock with expired lease or of process that doesn't exist anymore (on
+    // this host). Two workers can break the same lock, then shard is
+    // computed twice with the same result.
+    static bool stale(std::string const& lock) {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(lock, ec);
+        if (ec) {
+            // Released meanwhile.
+            return true;
+        }
+        if (std::filesystem::file_time_type::clock::now() - mtime > std::chrono::seconds(lease_timeout)) {
+            return true;
+        }
+        std::ifstream f(lock);
+        std::string lock_host;
+        int pid;
+        if (!(f >> lock_host >> pid)) {
+            return false;
+        }
+        return lock_host == host() && kill(pid, 0) != 0 && errno == ESRCH;
+    }
+
+    // Touches lock every lease_period seconds while it exists.
+    class Lease {
+        std::string lock;
+        std::mutex m;
+        std::condition_variable cv;
+        bool done = false;
+        std::thread t;
+
+    public:
+        Lease(std::string const& lock) : lock(lock) {
+            t = std::thread([this]() {
+                std::unique_lock<std::mutex> l(m);
+                while (!cv.wait_for(l, std::chrono::seconds(lease_period), [this]() { return done; })) {
+                    std::error_code ec;
+                    std::filesystem::last_write_time(this->lock, std::filesystem::file_time_type::clock::now(), ec);
+                }
+            });
+        }
+
+        ~Lease() {
+            {
+                std::lock_guard<std::mutex> l(m);
+                done = true;
+            }
+            cv.notify_one();
+            t.join();
+        }
+    };
+
+    bool claim(int split, int shard) const {
+        std::string lock = lock_file(split, shard);
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            int fd = open(lock.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+            if (fd >= 0) {
+                std::string owner = host() + " " + std::to_string(getpid()) + "\n";
+                bool ok = write(fd, owner.data(), owner.size()) == ssize_t(owner.size());
+                close(fd);
+                return ok;
+            }
+            if (!stale(lock)) {
+                return false;
+            }
+            std::remove(lock.c_str());
+        }
+        return false;
+    }
+
+    void stats(const MazeState& root_state, int split, int stats_iters, std::vector<int>& stats) const {
+        std::filesystem::create_directories(split_dir(split));
+        std::string filename = split_dir(split) + "/stats.txt";
+        std::string h = header(root_state);
+        stats.assign(root_state.grid.cells.size(), 0);
+        std::ifstream f(filename);
+        if (f.is_open()) {
+            if (check_header(f, h)) {
+                int c, count;
+                while (f >> c >> count) {
+                    if (c >= 0 && c < int(stats.size())) {
+                        stats[c] = count;
+                    }
+                }
+                return;
+            }
+            f.close();
+            discard(filename);
+        }
+        stats = compute_stats(root_state, stats_iters);
+        std::ostringstream ss;
+        ss << h << "\n";
+        for (size_t c = 0; c < stats.size(); ++c) {
+            if (stats[c]) {
+                ss << c << " " << stats[c] << "\n";
+            }
+        }
+        write_atomic(filename, ss.str());
+    }
+
+    void search(const MazeState& root_state, int split, int sim_iters, int search_iters, const SeedScorer& scorer, SeedScore& best) const {
+        std::string h = header(root_state);
+        int n_shards = (search_iters + shard_size - 1) / shard_size;
+        for (bool done = false; !done;) {
+            bool pending = false;
+            for (int j = 0; j < n_shards; ++j) {
+                if (std::filesystem::exists(shard_file(split, j))) {
+                    continue;
+                }
+                if (!claim(split, j)) {
+                    pending = true;
+                    continue;
+                }
+                int first_seed = 1 + j * shard_size;
+                int last_seed = std::min(search_iters, (j + 1) * shard_size);
+                SeedScore shard_best;
+                {
+                    Lease lease(lock_file(split, j));
+                    shard_best = find_best_seed(root_state, sim_iters, first_seed, last_seed, scorer);
+                }
+                write_atomic(shard_file(split, j), h + "\n" + std::to_string(shard_best.seed) + " " + std::to_string(shard_best.gain1) + " " + std::to_string(shard_best.gain2) + "\n");
+                std::remove(lock_file(split, j).c_str());
+            }
+            if (pending) {
+                // Wait for shards claimed by other workers.
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+
+            // Shards of other runs are computed again.
+            best = SeedScore();
+            done = true;
+            for (int j = 0; j < n_shards; ++j) {
+                std::ifstream f(shard_file(split, j));
+                if (!check_header(f, h)) {
+                    f.close();
+                    discard(shard_file(split, j));
+                    done = false;
+                    continue;
+                }
+                int seed;
+                long long gain1, gain2;
+                if (f >> seed >> gain1 >> gain2 && seed >= 0) {
+                    SeedScore candidate = scorer.score(seed, gain1, gain2);
+                    if (candidate.better(best)) {
+                        best = candidate;
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Command line: "-name value" pairs, problems is comma-separated list of
+// problem files.
+struct Options {
+    std::vector<std::string> problems;
+    int total_iters = 1000000;
+    int splits = 10;
+    int stats_iters = 1000;
+    int search_iters = 1000000 / 2;
+    // Directory with progress of every problem, run is resumed from it.
+    std::string checkpoint_dir;
+    // Directory for results of every problem, stdout if empty.
+    std::string output_dir;
+    // With shards_dir seeds are searched in shards stored in the directory,
+    // workers processes are started on this machine (more can be started
+    // on other machines with the same arguments).
+    std::string shards_dir;
+    int shard_size = 10000;
+    int workers = 1;
+
+    bool parse(int argc, char** argv) {
+        files::CommandLine cmd;
+        cmd.AddArg("problems", "problems/lambdaman/lambdaman19.txt");
+        cmd.AddArg("total_iters", total_iters);
+        cmd.AddArg("splits", splits);
+        cmd.AddArg("stats_iters", stats_iters);
+        cmd.AddArg("search_iters", search_iters);
+        cmd.AddArg("checkpoint", checkpoint_dir);
+        cmd.AddArg("output", output_dir);
+        cmd.AddArg("shards", shards_dir);
+        cmd.AddArg("shard_size", shard_size);
+        cmd.AddArg("workers", workers);
+        cmd.Parse(argc, argv);
+        problems = Split(cmd.GetString("problems"), ',');
+        total_iters = cmd.GetInt("total_iters");
+        splits = cmd.GetInt("splits");
+        stats_iters = cmd.GetInt("stats_iters");
+        search_iters = cmd.GetInt("search_iters");
+        checkpoint_dir = cmd.GetString("checkpoint");
+        output_dir = cmd.GetString("output");
+        shards_dir = cmd.GetString("shards");
+        shard_size = cmd.GetInt("shard_size");
+        workers = cmd.GetInt("workers");
+        return !problems.empty() && splits > 0 && shard_size > 0;
+    }
+
+    std::string header() const {
+        return std::to_string(total_iters) + " " + std::to_string(splits) + " " +
+               std::to_string(stats_iters) + " " + std::to_string(search_iters);
+    }
+};
+
+std::string problem_name(std::string const& filename) {
+    return std::filesystem::path(filename).stem().string();
+}
+
+// Checkpoint is the header with budgets followed by "seed steps" of finished
+// splits, state is restored by replaying them. Written after every split.
+bool save_checkpoint(std::string const& filename, Options const& options, const MazeState& state) {
+    std::ostringstream ss;
+    ss << options.header() << "\n";
+    for (auto& [seed, steps] : state.seeds_steps) {
+        ss << seed << " " << steps << "\n";
+    }
+    return ShardedSearch::write_atomic(filename, ss.str());
+}
+
+bool load_checkpoint(std::string const& filename, Options const& options, MazeState& state) {
+    std::ifstream f(filename);
+    if (!f.is_open()) {
+        return true;
+    }
+    std::string header;
+    std::getline(f, header);
+    if (header != options.header()) {
+        std::cerr << "Checkpoint " << filename << " was made with other budgets (" << header << ")" << std::endl;
+        return false;
+    }
+    int seed, steps;
+    while (f >> seed >> steps) {
+        state.simulate(seed, steps);
+    }
+    return true;
+}
+
+// Runs all splits for one problem with threads threads, result is
+// n_unvisited followed by "seed steps" lines.
+bool solve(Options const& options, std::string const& filename, int threads, std::string& result) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<std::string> maze;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        maze.push_back(line);
+    }
+    Grid grid(maze);
+    if (grid.cells.size() > max_padded_size) {
+        std::cerr << "Maze is too large: " << filename << std::endl;
+        return false;
+    }
+    MazeState root_state(grid);
+    omp_set_num_threads(threads);
+
+    std::string name = problem_name(filename);
+    std::string checkpoint;
+    if (!options.checkpoint_dir.empty()) {
+        checkpoint = options.checkpoint_dir + "/" + name + ".txt";
+        if (!load_checkpoint(checkpoint, options, root_state)) {
+            return false;
+        }
+    }
+    ShardedSearch sharded(options.shards_dir + "/" + name, options.header(), options.shard_size);
+    int sim_iters = options.total_iters / options.splits;
+
+    for (int split = root_state.seeds_steps.size(); split < options.splits; ++split) {
+        std::cerr << name << " split " << split << " " << root_state.n_unvisited << "\n";
+        SeedScore best;
+        if (options.shards_dir.empty()) {
+            auto stats = compute_stats(root_state, options.stats_iters);
+            best = find_best_seed(root_state, sim_iters, 1, options.search_iters, SeedScorer(root_state, stats));
+        } else {
+            std::vector<int> stats;
+            sharded.stats(root_state, split, options.stats_iters, stats);
+            sharded.search(root_state, split, sim_iters, options.search_iters, SeedScorer(root_state, stats), best);
+        }
+        if (best.seed >= 0) {
+            std::cerr << name << " best score: " << best.score << "(" << best.score1 << ", " << best.score2 << ") with seed " << best.seed << std::endl;
+        }
+
+        root_state.simulate(best.seed, sim_iters);
+        if (!checkpoint.empty() && !save_checkpoint(checkpoint, options, root_state)) {
+            std::cerr << "Failed to save checkpoint " << checkpoint << std::endl;
+        }
+    }
+
+    std::ostringstream ss;
+    ss << root_state.n_unvisited << "\n";
+    for (auto& [seed, steps] : root_state.seeds_steps) {
+        ss << seed << " " << steps << "\n";
+    }
+    result = ss.str();
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!options.parse(argc, argv)) {
+        return 1;
+    }
+    for (auto const& dir : {options.checkpoint_dir, options.output_dir, options.shards_dir}) {
+        if (!dir.empty()) {
+            std::filesystem::create_directories(dir);
+        }
+    }
+
+    // Workers are forked before any OpenMP region.
+    int workers = options.shards_dir.empty() ? 1 : options.workers;
+    std::vector<pid_t> children;
+    bool child = false;
+    for (int k = 1; k < workers && !child; ++k) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            child = true;
+        } else if (pid > 0) {
+            children.push_back(pid);
+        }
+    }
+
+    // Problems are solved in parallel, threads left are shared by the
+    // searches of every problem.
+    int n_problems = options.problems.size();
+    int threads = omp_get_max_threads();
+    int outer = std::min(n_problems, threads);
+    omp_set_max_active_levels(2);
+    bool ok = true;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(outer)
+    for (int i = 0; i < n_problems; ++i) {
+        std::string const& filename = options.problems[i];
+        std::string result;
+        bool solved = solve(options, filename, std::max(1, threads / outer), result);
+        #pragma omp critical
+        {
+            ok = ok && solved;
+            if (solved && !child) {
+                if (!options.output_dir.empty()) {
+                    std::string output = options.output_dir + "/" + problem_name(filename) + ".txt";
+                    if (!ShardedSearch::write_atomic(output, result)) {
+                        std::cerr << "Failed to save " << output << std::endl;
+                        ok = false;
+                    }
+                } else {
+                    if (n_problems > 1) {
+                        std::cout << problem_name(filename) << "\n";
+                    }
+                    std::cout << result << std::flush;
+                }
+            }
+        }
+    }
+    if (child) {
+        return ok ? 0 : 1;
+    }
+    for (pid_t pid : children) {
+        waitpid(pid, nullptr, 0);
+    }
+    return ok ? 0 : 1;
+}
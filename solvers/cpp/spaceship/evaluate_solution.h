@@ -14,13 +14,29 @@ inline void EvaluateSolution(const std::string& solver_name) {
   for (unsigned i = 1; i <= last_problem; ++i) {
     auto r = solvers::ext::Evaluate<Evaluator, Problem, Solution>(
         std::to_string(i), solver_name);
-    total += (r.correct ? std::max(r.score, 0ll) : int64_t(max_moves));
+    total += (r.correct ? std::max<int64_t>(r.score, 0) : int64_t(max_moves));
     std::cout << "Problem " << std::to_string(1000 + i).substr(1) << "\t"
               << r.correct << "\t" << r.score << std::endl;
   }
   std::cout << "Total = " << total << std::endl;
 }
 
+// Rewrites stored solutions in format selected by Solution::SavePacked().
+inline void ConvertSolution(const std::string& solver_name) {
+  for (unsigned i = 1; i <= last_problem; ++i) {
+    auto id = std::to_string(i);
+    auto r = solvers::ext::EvaluateStored<Evaluator, Problem, Solution>(
+        id, solver_name);
+    if (r.score == -2) continue;
+    Solution s;
+    if (!s.Load(id, solver_name)) {
+      std::cout << "Failed to read solution for problem: " << i << std::endl;
+      continue;
+    }
+    solvers::ext::SaveStored(s, solver_name, r);
+  }
+}
+
 inline void UpdateBest(const std::string& solver_name) {
   for (unsigned i = 1; i <= last_problem; ++i) {
     auto b = solvers::ext::UpdateBest<Evaluator, Problem, Solution>(
@@ -4,14 +4,10 @@
 #include "spaceship/map.h"
 #include "spaceship/problem.h"
 #include "spaceship/solution.h"
-#include "spaceship/spaceship.h"
+#include "spaceship/utils/parallel_validator.h"
 
-#include "common/geometry/d2/point.h"
-#include "common/geometry/d2/stl_hash/point.h"
 #include "common/solvers/evaluator.h"
 
-#include <unordered_set>
-
 namespace spaceship {
 class Evaluator : public solvers::Evaluator {
  public:
@@ -21,26 +17,18 @@ class Evaluator : public solvers::Evaluator {
     return l.correct ? r.correct ? l.score < r.score : true : false;
   }
 
-  // Check if solution valid
-  static bool Valid(const Problem& p, const Solution& s) {
-    if (s.commands.size() > max_moves) return false;
-    std::unordered_set<I2Point> ps;
-    for (const auto& pp : p.GetPoints()) {
-      ps.insert(pp);
-    }
-    SpaceShip ss;
-    for (auto c : ("5" + s.commands)) {
-      ss.ApplyCommand(c);
-      auto it = ps.find(ss.p);
-      if (it != ps.end()) {
-        ps.erase(it);
-      }
-    }
-    return ps.empty();
+  // Check if solution valid, nthreads is thread budget of caller (0 -- all
+  // hardware threads).
+  static bool Valid(const Problem& p, const Solution& s,
+                    unsigned nthreads = 0) {
+    if (s.View().size() > max_moves) return false;
+    return ParallelValidator::Valid(p.GetPoints(), s.View(), nthreads);
   }
 
-  static Result Apply(const Problem& p, const Solution& s) {
-    return Valid(p, s) ? Result(true, s.commands.size()) : Result(false, 0);
+  static Result Apply(const Problem& p, const Solution& s,
+                      unsigned nthreads = 0) {
+    return Valid(p, s, nthreads) ? Result(true, s.View().size())
+                                 : Result(false, 0);
   }
 };
 }  // namespace spaceship
@@ -24,19 +24,54 @@
 #include "spaceship/solvers/line_sweep2b.h"
 
 #include "common/files/command_line.h"
+#include "common/memory/system.h"
+#include "common/solvers/bench_report.h"
+#include "common/solvers/ext/bench.h"
+#include "common/solvers/ext/race.h"
 #include "common/solvers/ext/run_n.h"
+#include "common/solvers/ext/sweep.h"
+#include "common/solvers/param_space.h"
+#include "common/stats/registry.h"
+#include "common/stats/trace.h"
+#include "common/string/utils/split.h"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 void InitCommaneLine(files::CommandLine& cmd) {
   cmd.AddArg("mode", "eval");
   cmd.AddArg("solution", "best");
   cmd.AddArg("solver", "greedy1");
+  cmd.AddArg("portfolio", "greedy3ls,ls2,greedyls1,dp2");  // For race mode
+  // Bench mode runs solvers from portfolio, output is CSV or JSON (by
+  // extension), compare mode checks output against CSV baseline.
+  cmd.AddArg("bench_repetitions", 3);
+  cmd.AddArg("bench_output", "bench.csv");
+  cmd.AddArg("bench_baseline", "");
+  cmd.AddArg("bench_tolerance", 10);  // %
+  cmd.AddArg("bench_perf", 0);  // Record hardware counters (Linux only)
+  // Sweep mode runs solver with parameters from space
+  // "name=v1,v2,first:last[:step];name2=..." (names are command line args),
+  // strategy is grid, random (sweep_samples configurations) or halving
+  // (random sample, better half survives with doubled time limit).
+  cmd.AddArg("sweep_params", "");
+  cmd.AddArg("sweep_strategy", "grid");
+  cmd.AddArg("sweep_samples", 16);
+  cmd.AddArg("sweep_seed", 1);
+  cmd.AddArg("sweep_output", "sweep.csv");
+  cmd.AddArg("packed", 0);  // Save solutions in binary format
   cmd.AddArg("timelimit", 125);
+  cmd.AddArg("checkpoint_interval", 0);
+  cmd.AddArg("resume", 0);
   cmd.AddArg("max_extra", 5);
   cmd.AddArg("max_speed_at_stop", 100);
+  cmd.AddArg("greedy3ls_msas", -1);  // -1 - try all default values
   cmd.AddArg("max_steps_between_points", 100);
   cmd.AddArg("nthreads", 4);
+  cmd.AddArg("memory_limit", 0);  // MB, 0 - 3/4 of physical memory
+  cmd.AddArg("stats", 1);  // Print solver stats per problem
+  cmd.AddArg("trace", "");  // Chrome trace-event JSON output file
   cmd.AddArg("first_problem", 1);
   cmd.AddArg("last_problem", spaceship::last_problem);
 }
@@ -60,7 +95,8 @@ spaceship::BaseSolver::PSolver CreateSolver(const files::CommandLine& cmd,
     return std::make_shared<spaceship::Greedy3>(
         cmd.GetInt("max_speed_at_stop"));
   } else if (solver_name == "greedy3ls") {
-    return std::make_shared<spaceship::Greedy3LS>(timelimit);
+    return std::make_shared<spaceship::Greedy3LS>(
+        timelimit, cmd.GetInt("greedy3ls_msas"));
   } else if (solver_name == "greedyls1") {
     return std::make_shared<spaceship::GreedyLS1>(timelimit);
   } else if (solver_name == "dp1") {
@@ -68,13 +104,15 @@ spaceship::BaseSolver::PSolver CreateSolver(const files::CommandLine& cmd,
   } else if (solver_name == "dp1a") {
     return std::make_shared<spaceship::DP1A>(timelimit);
   } else if (solver_name == "dp2") {
-    return std::make_shared<spaceship::DP2>(timelimit);
+    return std::make_shared<spaceship::DP2>(
+        timelimit, cmd.GetInt("checkpoint_interval"), cmd.GetInt("resume"));
   } else if (solver_name == "dp2a") {
     return std::make_shared<spaceship::DP2A>(timelimit);
   } else if (solver_name == "ls1") {
     return std::make_shared<spaceship::LineSweep1>(timelimit);
   } else if (solver_name == "ls1a") {
-    return std::make_shared<spaceship::LineSweep1A>(timelimit);
+    return std::make_shared<spaceship::LineSweep1A>(
+        timelimit, cmd.GetInt("checkpoint_interval"), cmd.GetInt("resume"));
   } else if (solver_name == "ls2") {
     return std::make_shared<spaceship::LineSweep2>(timelimit, cmd.GetInt("max_steps_between_points"), cmd.GetInt("max_extra"));
   } else if (solver_name == "ls2a") {
@@ -87,20 +125,93 @@ spaceship::BaseSolver::PSolver CreateSolver(const files::CommandLine& cmd,
   }
 }
 
+uint64_t MemoryLimit(const files::CommandLine& cmd) {
+  return (cmd.GetInt("memory_limit") > 0)
+             ? (uint64_t(cmd.GetInt("memory_limit")) << 20)
+             : memory::PhysicalMemory() / 4 * 3;
+}
+
+// Returns number of regressions.
+unsigned CompareBench(const files::CommandLine& cmd,
+                      const solvers::BenchReport& report) {
+  solvers::BenchReport baseline;
+  if (!baseline.LoadCSV(cmd.GetString("bench_baseline"))) {
+    std::cerr << "Failed to read baseline " << cmd.GetString("bench_baseline")
+              << std::endl;
+    return 1;
+  }
+  return report.Compare(baseline, cmd.GetInt("bench_tolerance") / 100.);
+}
+
+// Returns 0 on success.
+int RunSweep(const files::CommandLine& cmd) {
+  solvers::ParamSpace space;
+  if (!space.Parse(cmd.GetString("sweep_params"))) {
+    std::cerr << "Invalid sweep_params: " << cmd.GetString("sweep_params")
+              << std::endl;
+    return 1;
+  }
+  auto strategy = cmd.GetString("sweep_strategy");
+  if ((strategy != "grid") && (strategy != "random") &&
+      (strategy != "halving")) {
+    std::cerr << "Unknown sweep_strategy " << strategy << std::endl;
+    return 1;
+  }
+  auto configs = (strategy == "grid")
+                     ? space.Grid()
+                     : space.Random(cmd.GetInt("sweep_samples"),
+                                    cmd.GetInt("sweep_seed"));
+  if (configs.empty()) {
+    std::cerr << "No configurations to sweep." << std::endl;
+    return 1;
+  }
+  for (auto& it : configs.front()) {
+    if (!cmd.HasInt(it.first)) {
+      std::cerr << "Unknown parameter " << it.first << std::endl;
+      return 1;
+    }
+  }
+  auto solver_name = cmd.GetString("solver");
+  int nthreads = std::max(cmd.GetInt("nthreads"), 1);
+  auto memory_limit = MemoryLimit(cmd);
+  memory::SetProcessLimit(memory_limit);
+  auto factory = [&](const solvers::Params& params, unsigned timelimit) {
+    auto cmd_config = cmd;
+    for (auto& it : params) cmd_config.AddArg(it.first, it.second);
+    cmd_config.AddArg("timelimit", int(timelimit));
+    auto s = CreateSolver(cmd_config, solver_name);
+    s->SetMaxMemory(memory_limit / nthreads);
+    return s;
+  };
+  solvers::ext::Sweep<spaceship::BaseSolver>(
+      factory, solver_name, configs, cmd.GetInt("first_problem"),
+      cmd.GetInt("last_problem"), cmd.GetInt("timelimit"), nthreads,
+      strategy == "halving", cmd.GetString("sweep_output"));
+  return 0;
+}
+
 int main(int argc, char** argv) {
   files::CommandLine cmd;
   InitCommaneLine(cmd);
   cmd.Parse(argc, argv);
 
+  spaceship::Solution::SavePacked() = cmd.GetInt("packed");
+  stats::SetEnabled(cmd.GetInt("stats"));
+  stats::TraceFile trace_file(cmd.GetString("trace"));
   const auto mode = cmd.GetString("mode");
   if (mode == "eval") {
     spaceship::EvaluateSolution(cmd.GetString("solution"));
+  } else if (mode == "convert") {
+    spaceship::ConvertSolution(cmd.GetString("solution"));
   } else if (mode == "update") {
     spaceship::UpdateBest(cmd.GetString("solution"));
   } else if (mode == "run") {
     auto solver_name = cmd.GetString("solver");
     auto s = CreateSolver(cmd, solver_name);
     int nthreads = cmd.GetInt("nthreads");
+    auto memory_limit = MemoryLimit(cmd);
+    memory::SetProcessLimit(memory_limit);
+    s->SetMaxMemory(memory_limit / std::max(nthreads, 1));
     if (nthreads <= 0)
       solvers::ext::RunN<spaceship::BaseSolver>(*s, cmd.GetInt("first_problem"),
                                                 cmd.GetInt("last_problem"));
@@ -108,6 +219,44 @@ int main(int argc, char** argv) {
       solvers::ext::RunNMT<spaceship::BaseSolver>(
           *s, cmd.GetInt("first_problem"), cmd.GetInt("last_problem"),
           nthreads);
+  } else if (mode == "race") {
+    std::vector<spaceship::BaseSolver::PSolver> portfolio;
+    for (auto& solver_name : Split(cmd.GetString("portfolio"), ","))
+      portfolio.push_back(CreateSolver(cmd, solver_name));
+    auto memory_limit = MemoryLimit(cmd);
+    memory::SetProcessLimit(memory_limit);
+    for (auto& s : portfolio)
+      s->SetMaxMemory(memory_limit / std::max<size_t>(portfolio.size(), 1));
+    solvers::ext::RaceN<spaceship::BaseSolver>(
+        portfolio, cmd.GetInt("first_problem"), cmd.GetInt("last_problem"));
+  } else if (mode == "bench") {
+    std::vector<spaceship::BaseSolver::PSolver> portfolio;
+    for (auto& solver_name : Split(cmd.GetString("portfolio"), ","))
+      portfolio.push_back(CreateSolver(cmd, solver_name));
+    auto memory_limit = MemoryLimit(cmd);
+    memory::SetProcessLimit(memory_limit);
+    for (auto& s : portfolio) s->SetMaxMemory(memory_limit);
+    solvers::BenchReport report;
+    solvers::ext::Bench<spaceship::BaseSolver>(
+        portfolio, cmd.GetInt("first_problem"), cmd.GetInt("last_problem"),
+        cmd.GetInt("bench_repetitions"), report, cmd.GetInt("bench_perf"));
+    if (!report.Save(cmd.GetString("bench_output"))) {
+      std::cerr << "Failed to save " << cmd.GetString("bench_output")
+                << std::endl;
+      return 1;
+    }
+    if (!cmd.GetString("bench_baseline").empty())
+      return CompareBench(cmd, report) ? 1 : 0;
+  } else if (mode == "sweep") {
+    return RunSweep(cmd);
+  } else if (mode == "compare") {
+    solvers::BenchReport report;
+    if (!report.LoadCSV(cmd.GetString("bench_output"))) {
+      std::cerr << "Failed to read " << cmd.GetString("bench_output")
+                << std::endl;
+      return 1;
+    }
+    return CompareBench(cmd, report) ? 1 : 0;
   } else {
     std::cerr << "Unknown mode " << mode << std::endl;
   }
@@ -1,10 +1,9 @@
 #pragma once
 
-#include "common/files/file_to_string.h"
+#include "common/files/mapped_file.h"
 #include "common/geometry/d2/point.h"
-#include "common/geometry/d2/point_io.h"
+#include "common/geometry/d2/point_parse.h"
 #include "common/solvers/problem.h"
-#include "common/vector/read_from_string.h"
 
 #include <vector>
 
@@ -24,9 +23,9 @@ class Problem : public solvers::Problem {
 
   bool Load(const std::string& _id, const std::string& filename) {
     id = _id;
-    points =
-        nvector::ReadFromString<I2Point>(files::FileToString(filename), "\n");
-    return !points.empty();
+    files::MappedFile f(filename);
+    return geometry::d2::ParsePoints<int64_t>(f.View(), points) &&
+           !points.empty();
   }
 };
 }  // namespace spaceship
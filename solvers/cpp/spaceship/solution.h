@@ -1,37 +1,170 @@
 #pragma once
 
-#include "common/files/file_to_string.h"
+#include "spaceship/utils/packed_commands.h"
+
+#include "common/files/mapped_file.h"
 #include "common/solvers/solution.h"
 
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace spaceship {
 class Solution : public solvers::Solution {
- public:
+ protected:
   std::string commands;
+  // Solution file mapped by LoadView, used instead of commands.
+  std::shared_ptr<files::MappedFile> mapping;
+  // Packed form of commands built by Append (only if SavePacked()), so Save
+  // doesn't encode them again. Reset when commands are changed otherwise.
+  std::optional<CommandsEncoder> encoder;
 
  public:
-  bool Empty() const { return commands.empty(); }
-  void Clear() { commands.clear(); }
+  bool Empty() const { return View().empty(); }
+  void Clear() {
+    commands.clear();
+    mapping.reset();
+    encoder.reset();
+  }
+
+  // Commands without copy, valid while solution (or its copy) exists.
+  std::string_view View() const {
+    return mapping ? mapping->View() : std::string_view(commands);
+  }
+
+  // Mapped file (if any) is copied into commands and released, so changes
+  // are never hidden by mapping.
+  std::string& MutableCommands() {
+    MaterializeMapping();
+    encoder.reset();
+    return commands;
+  }
+
+  // Appends commands and, if solution is saved packed, encodes them at once.
+  void Append(std::string_view part) {
+    bool track = SavePacked() && (encoder || Empty());
+    MaterializeMapping();
+    if (track) {
+      if (!encoder) encoder.emplace();
+      if (!encoder->Append(part)) encoder.reset();
+    } else {
+      encoder.reset();
+    }
+    commands.append(part);
+  }
+
+  void Reserve(size_t expected_size) {
+    MaterializeMapping();
+    commands.reserve(expected_size);
+    if (SavePacked() && (encoder || commands.empty())) {
+      if (!encoder) encoder.emplace();
+      encoder->Reserve(expected_size);
+    }
+  }
+
+  // Format used by Save, Load detects format of file itself.
+  static bool& SavePacked() {
+    static bool packed = false;
+    return packed;
+  }
 
+  // Packed solutions are stored with own extension, text consumers of .txt
+  // files never see binary data.
   static std::string FileName(const std::string& id,
-                              const std::string& solver_name) {
-    return "../../solutions/spaceship/" + solver_name + "/" + id + ".txt";
+                              const std::string& solver_name,
+                              bool packed = false) {
+    return "../../solutions/spaceship/" + solver_name + "/" + id +
+           (packed ? ".sspk" : ".txt");
+  }
+
+  // File with stored solution, packed one if it exists.
+  static std::string StoredFileName(const std::string& id,
+                                    const std::string& solver_name) {
+    auto packed = FileName(id, solver_name, true);
+    std::error_code ec;
+    return std::filesystem::exists(packed, ec) ? packed
+                                               : FileName(id, solver_name);
+  }
+
+  static std::string BoundsFileName(const std::string& id) {
+    return "../../solutions/spaceship/bounds/" + id + ".txt";
+  }
+
+  static std::string IndexFileName(const std::string& solver_name) {
+    return "../../solutions/spaceship/index/" + solver_name + ".txt";
   }
 
   bool Load(const std::string& id, const std::string& solver_name) {
     SetId(id);
-    auto filename = FileName(GetId(), solver_name);
-    commands = files::FileToString(filename);
+    mapping.reset();
+    encoder.reset();
+    files::MappedFile f(StoredFileName(GetId(), solver_name));
+    if (CommandsEncoder::IsPacked(f.View()))
+      CommandsEncoder::Decode(f.View(), commands);
+    else
+      commands.assign(f.View());
     return !commands.empty();
   }
 
+  // Read-only load, commands stay empty and View() is over mapped file
+  // (packed files are decoded into commands).
+  bool LoadView(const std::string& id, const std::string& solver_name) {
+    SetId(id);
+    commands.clear();
+    encoder.reset();
+    mapping = std::make_shared<files::MappedFile>(
+        StoredFileName(GetId(), solver_name));
+    if (CommandsEncoder::IsPacked(mapping->View())) {
+      CommandsEncoder::Decode(mapping->View(), commands);
+      mapping.reset();
+    }
+    return !Empty();
+  }
+
+  // Data is written into temporary file and renamed, so readers and mapped
+  // views of the old file never observe partially written file. File of the
+  // other format (if any) is removed.
   void Save(const std::string& solver_name) const {
-    auto filename = FileName(GetId(), solver_name);
-    std::ofstream f(filename);
-    f << commands;
+    std::string packed;
+    bool use_packed = false;
+    if (SavePacked()) {
+      if (encoder && (encoder->Size() == View().size())) {
+        packed = encoder->Finish();
+        use_packed = true;
+      } else {
+        // Commands that can't be packed are kept as text.
+        use_packed = CommandsEncoder::Encode(View(), packed);
+      }
+    }
+    auto filename = FileName(GetId(), solver_name, use_packed);
+    auto tmp_filename = filename + ".tmp";
+    std::ofstream f(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (use_packed) {
+      f << packed;
+    } else {
+      auto v = View();
+      f.write(v.data(), v.size());
+    }
+    f.close();
+    if (!f) {
+      std::remove(tmp_filename.c_str());
+      return;
+    }
+    std::rename(tmp_filename.c_str(), filename.c_str());
+    std::remove(FileName(GetId(), solver_name, !use_packed).c_str());
+  }
+
+ protected:
+  void MaterializeMapping() {
+    if (mapping) {
+      commands.assign(mapping->View());
+      mapping.reset();
+    }
   }
 };
 }  // namespace spaceship
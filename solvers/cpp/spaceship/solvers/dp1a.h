@@ -3,21 +3,17 @@
 #include "spaceship/map.h"
 #include "spaceship/solvers/base.h"
 #include "spaceship/spaceship.h"
+#include "spaceship/utils/best_first_search.h"
 #include "spaceship/utils/drop_dups.h"
+#include "spaceship/utils/lower_bound.h"
 
-#include "common/geometry/d2/distance/distance_linf.h"
-#include "common/geometry/d2/point_io.h"
-#include "common/geometry/d2/stl_hash/point.h"
-#include "common/geometry/d2/vector_io.h"
 #include "common/hash.h"
-#include "common/heap.h"
 #include "common/solvers/solver.h"
 #include "common/stl/hash/vector.h"
 #include "common/timer.h"
 
 #include <algorithm>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace spaceship {
@@ -38,26 +34,58 @@ class DP1A : public BaseSolver {
   // bool SkipBest() const override { return true; }
 
  protected:
-  class Task {
+  class State {
    public:
     SpaceShip ss;
     std::vector<uint8_t> visited;
-    unsigned cost;
-    size_t source_hash;
+    unsigned covered = 0;
 
-    size_t Hash() const {
-      return HashCombine(ss.Hash(), std::hash<std::vector<uint8_t>>{}(visited));
+    size_t Memory() const { return visited.capacity() * sizeof(uint8_t); }
+  };
+
+  class Key {
+   public:
+    static size_t Hash(const State& s) {
+      return HashCombine(s.ss.Hash(),
+                         std::hash<std::vector<uint8_t>>{}(s.visited));
+    }
+
+    static bool Same(const State& l, const State& r) {
+      return (l.ss == r.ss) && (l.visited == r.visited);
     }
   };
 
-  class TaskInfo {
+  // Every move visits at most one point.
+  class Heuristic {
+   protected:
+    const std::vector<I2Point>& tvp;
+
    public:
-    size_t hash;
-    unsigned cost;
+    explicit Heuristic(const std::vector<I2Point>& _tvp) : tvp(_tvp) {}
+
+    unsigned Layers() const { return tvp.size() + 1; }
+    unsigned Layer(const State& s) const { return s.covered; }
+
+    bool Move(const State& from, State& to) const {
+      to.visited = from.visited;
+      to.covered = from.covered;
+      for (unsigned j = 0; j < tvp.size(); ++j) {
+        if (!to.visited[j] && (tvp[j] == to.ss.p)) {
+          to.visited[j] = true;
+          to.covered += 1;
+        }
+      }
+      return true;
+    }
 
-    bool operator<(const TaskInfo& r) const { return cost < r.cost; }
+    unsigned MinExtraCost(const State& s, bool& exact) const {
+      exact = (s.covered == tvp.size());
+      return tvp.size() - s.covered;
+    }
   };
 
+  using TSearch = BestFirstSearch<State, Key, Heuristic>;
+
  public:
   Solution Solve(const TProblem& p) override {
     Timer t;
@@ -65,119 +93,39 @@ class DP1A : public BaseSolver {
     s.SetId(p.Id());
     auto tvp = DropDups(p.GetPoints());
 
-    // Init heap
-    std::unordered_map<size_t, Task> tasks;
-    std::vector<HeapMinOnTop<TaskInfo>> vheap;
-    vheap.resize(tvp.size() + 1);
-    Task task_init;
-    task_init.visited = std::vector<uint8_t>(tvp.size(), false);
-    task_init.cost = 0;
-    task_init.source_hash = 0;
-    auto task_init_hash = task_init.Hash();
-    tasks[task_init_hash] = task_init;
-    vheap[0].Add({task_init_hash, task_init.cost});
-
-    unsigned best_solution = 10000000;
-    unsigned status = 0;
-    uint64_t hash_conflicts = 0;
-    std::vector<unsigned> best_candidate(vheap.size() + 1, best_solution);
-    for (;;) {
+    // Init search
+    Heuristic heuristic(tvp);
+    TSearch search(heuristic);
+    State state_init;
+    state_init.visited = std::vector<uint8_t>(tvp.size(), false);
+    search.Init(state_init);
+
+    auto status = search.Run([&]() -> unsigned {
       if (t.GetSeconds() > max_time_in_seconds) {
         // Time to stop
-        status = 1;
-        break;
+        return 1;
       }
-      if (tasks.size() * (tvp.size() + 40) > (1ull << 32)) {
+      if (OverMemory(search.Counter())) {
         // Avoid over memory usage
-        status = 2;
-        break;
-      }
-      for (unsigned i = vheap.size(); i-- > 0;) {
-        best_candidate[i] = std::min<unsigned>(
-            vheap[i].Empty() ? best_solution
-                             : vheap[i].Top().cost + tvp.size() - i,
-            best_candidate[i + 1]);
+        return 2;
       }
-      bool done = true;
-      for (unsigned i = 0; i < vheap.size(); ++i) {
-        if (vheap[i].Empty()) continue;
-        auto best_i = vheap[i].Top().cost;
-        if (best_i + tvp.size() - i >= best_solution) {
-          vheap[i].Clear();
-          continue;
-        }
-        if (best_i + tvp.size() - i > best_candidate[i]) {
-          continue;
-        }
-        done = false;
-        if (i == tvp.size()) {
-          // New best solution
-          best_solution = best_i;
-          std::cout << "New best solution with cost " << best_solution
-                    << std::endl;
-          std::string ss;
-          auto t_hash = vheap[i].Top().hash;
-          auto t = &(tasks[t_hash]);
-          for (; t->cost > 0;) {
-            auto t2 = &(tasks[t->source_hash]);
-            ss += V2C(t->ss.v - t2->ss.v);
-            t = t2;
-          }
-          std::reverse(ss.begin(), ss.end());
-          s.commands = ss;
-          break;
-        }
-        // for (; !vheap[i].Empty() && (vheap[i].Top().cost == best_i);)
-        {
-          auto t_hash = vheap[i].Top().hash;
-          vheap[i].Pop();
-          auto t = tasks[t_hash];
-          if (t.cost < best_i) {
-            // Already processed
-            continue;
-          }
-          // One steps search
-          for (int idx = -1; idx <= 1; ++idx) {
-            for (int idy = -1; idy <= 1; ++idy) {
-              I2Vector idv(idx, idy);
-              Task task_new;
-              task_new.ss.p = t.ss.p + t.ss.v + idv;
-              task_new.ss.v = task_new.ss.p - t.ss.p;
-              task_new.visited = t.visited;
-              unsigned shift = 0;
-              for (unsigned j = 0; j < tvp.size(); ++j) {
-                if (!task_new.visited[j] && (tvp[j] == task_new.ss.p)) {
-                  task_new.visited[j] = true;
-                  shift += 1;
-                }
-              }
-              task_new.cost = best_i + 1;
-              task_new.source_hash = t_hash;
-              auto task_new_hash = task_new.Hash();
-              auto it = tasks.find(task_new_hash);
-              if (it == tasks.end()) {
-                tasks[task_new_hash] = task_new;
-              } else if (it->second.ss != task_new.ss) {
-                // Hash conflict, skipping
-                ++hash_conflicts;
-                continue;
-              } else if (it->second.cost > task_new.cost) {
-                it->second.cost = task_new.cost;
-                it->second.source_hash = task_new.source_hash;
-              } else {
-                // Already processed
-                continue;
-              }
-              vheap[i + shift].Add({task_new_hash, task_new.cost});
-            }
-          }
-        }
+      if (RaceStopped()) {
+        // Other solver found optimal solution
+        return 3;
       }
-      if (done) break;
-    }
-    std::cout << "\tStatus = " << status << "\tCashe size = " << tasks.size()
-              << "\tHash conflicts = " << hash_conflicts << std::endl;
-    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.commands.size() << std::endl;
+      auto race_incumbent =
+          RaceExchange(search.Found() ? int64_t(search.BestSolution()) : -1);
+      if (race_incumbent >= 0) search.SetUpperBound(race_incumbent);
+      return 0;
+    });
+    search.ReportStats();
+    ReportStatus(status);
+    s.Append(search.Commands());
+    lower_bound = std::max(MinMovesLowerBound(tvp), search.LowerBound());
+    incumbent = s.Empty() ? -1 : int64_t(s.View().size());
+    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
+              << s.View().size() << "\tLower bound = " << lower_bound
+              << std::endl;
     return s;
   }
 };
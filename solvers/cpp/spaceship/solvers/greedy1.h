@@ -83,9 +83,9 @@ class Greedy1 : public BaseSolver {
   Solution Solve(const TProblem& p) override {
     Solution s;
     s.SetId(p.Id());
-    s.commands = SolveI(DropDups(p.GetPoints(), true));
+    s.Append(SolveI(DropDups(p.GetPoints(), true)));
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
+              << s.View().size() << std::endl;
     return s;
   }
 };
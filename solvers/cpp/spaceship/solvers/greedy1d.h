@@ -40,12 +40,12 @@ class Greedy1D : public BaseSolver {
           std::swap(vp[i], vp.back());
         }
       }
-      s.commands += Greedy1::RunAndStopS(vp.back() - last);
+      s.Append(Greedy1::RunAndStopS(vp.back() - last));
       last = vp.back();
       vp.pop_back();
     }
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
+              << s.View().size() << std::endl;
     return s;
   }
 };
@@ -38,9 +38,9 @@ class Greedy1S : public BaseSolver {
     auto s1 = Greedy1::SolveI(vp);
     std::sort(vp.begin(), vp.end(), CompareYX<int64_t>);
     auto s2 = Greedy1::SolveI(vp);
-    s.commands = (s1.size() <= s2.size()) ? s1 : s2;
+    s.MutableCommands() = (s1.size() <= s2.size()) ? s1 : s2;
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
+              << s.View().size() << std::endl;
     return s;
   }
 };
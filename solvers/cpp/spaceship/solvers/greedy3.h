@@ -98,10 +98,10 @@ class Greedy3 : public BaseSolver {
 
     // Shuffle and use random seeds
     std::shuffle(tvp.begin(), tvp.end(), std::mt19937(17));
-    s.commands = SolveI(tvp);
+    s.Append(SolveI(tvp));
 
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
+              << s.View().size() << std::endl;
     return s;
   }
 };
@@ -8,6 +8,7 @@
 #include "spaceship/utils/drop_dups.h"
 
 #include "common/solvers/solver.h"
+#include "common/stats/trace.h"
 
 #include <algorithm>
 #include <string>
@@ -19,9 +20,24 @@ class Greedy3LS : public BaseSolver {
   using TBase = BaseSolver;
   using PSolver = TBase::PSolver;
 
+ protected:
+  // Max speed at stop values to try.
+  std::vector<unsigned> vmsas;
+
  public:
-  Greedy3LS() : BaseSolver() {}
-  explicit Greedy3LS(unsigned _max_time) : BaseSolver(_max_time) {}
+  static std::vector<unsigned> DefaultMaxSpeedAtStop() {
+    return {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13,
+            14, 15, 16, 17, 18, 19, 20, 22, 24, 26, 28, 30, 33, 36,
+            39, 42, 46, 50, 55, 60, 66, 72, 79, 86, 94, 103};
+  }
+
+  Greedy3LS() : BaseSolver(), vmsas(DefaultMaxSpeedAtStop()) {}
+  // Negative max_speed_at_stop - try all default values.
+  explicit Greedy3LS(unsigned _max_time, int _max_speed_at_stop = -1)
+      : BaseSolver(_max_time),
+        vmsas(_max_speed_at_stop < 0
+                  ? DefaultMaxSpeedAtStop()
+                  : std::vector<unsigned>{unsigned(_max_speed_at_stop)}) {}
 
   PSolver Clone() const override { return std::make_shared<Greedy3LS>(*this); }
 
@@ -31,6 +47,10 @@ class Greedy3LS : public BaseSolver {
   // bool SkipBest() const override { return true; }
 
   static std::string SolveI(const std::vector<I2Point>& line, unsigned max_speed_at_stop) {
+    stats::Span span("SolveI", "solver", [&]() -> stats::Trace::TArgs {
+      return {{"solver", "greedy3ls"},
+              {"max_speed_at_stop", std::to_string(max_speed_at_stop)}};
+    });
     std::string sr;
     SpaceShip ss;
     for (unsigned il = 0; il < line.size(); ++il) {
@@ -43,6 +63,7 @@ class Greedy3LS : public BaseSolver {
         }
       }
     }
+    span.AddArg("cost", std::to_string(sr.size()));
     return sr;
   }
 
@@ -53,22 +74,22 @@ class Greedy3LS : public BaseSolver {
     auto line = ConstructLine(tvp);
     auto line2 = line;
     std::reverse(line2.begin(), line2.end());
-
-    std::vector<unsigned> vmsas{0,  1,  2,  3,  4,  5,  6,  7,  8,  9,
-                                10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
-                                20, 22, 24, 26, 28, 30, 33, 36, 39, 42,
-                                46, 50, 55, 60, 66, 72, 79, 86, 94, 103};
     for (auto msas : vmsas) {
+      // Other solver found optimal solution
+      if (RaceStopped()) break;
       for (const auto& l : {line, line2}) {
         auto sl = SolveI(l, msas);
-        if (!sl.empty() && (s.commands.empty() || (s.commands.size() > sl.size()))) {
-          s.commands = sl;
+        if (!sl.empty() && (s.Empty() || (s.View().size() > sl.size()))) {
+          s.MutableCommands() = sl;
+          stats::Instant("improvement", "solver", [&]() -> stats::Trace::TArgs {
+            return {{"cost", std::to_string(sl.size())}};
+          });
         }
       }
     }                                
 
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
+              << s.View().size() << std::endl;
     return s;
   }
 };
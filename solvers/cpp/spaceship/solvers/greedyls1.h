@@ -9,6 +9,7 @@
 #include "spaceship/utils/two_points_solver.h"
 
 #include "common/solvers/solver.h"
+#include "common/stats/trace.h"
 
 #include <algorithm>
 #include <string>
@@ -31,17 +32,21 @@ class GreedyLS1 : public BaseSolver {
   bool SkipSolutionRead() const override { return true; }
   // bool SkipBest() const override { return true; }
 
-  static std::string SolveI(const std::vector<I2Point>& line, unsigned max_time_in_seconds) {
+  std::string SolveI(const std::vector<I2Point>& line, unsigned max_time_in_seconds) {
+    stats::Span span("SolveI", "solver", [&]() -> stats::Trace::TArgs {
+      return {{"solver", Name()}, {"points", std::to_string(line.size())}};
+    });
     Timer t;
     OnePointSolver ps1;
     thread_local TwoPointsSolver ps2;
-    ps2.ResetHashConflicts();
+    ps2.ResetCounters();
     std::string sr;
     SpaceShip ss;
     unsigned covered = 0;
     unsigned time_per_step = (max_time_in_seconds * 1000) / line.size();
     for (; covered + 1 < line.size();) {
-      auto c = (t.GetSeconds() < max_time_in_seconds)
+      // After time limit or end of race finish with fast one point moves.
+      auto c = ((t.GetSeconds() < max_time_in_seconds) && !RaceStopped())
                    ? ps2.BestMove(ss.v, (line[covered] - ss.p).ToPoint(),
                                   (line[covered + 1] - ss.p).ToPoint(),
                                   time_per_step)
@@ -61,9 +66,12 @@ class GreedyLS1 : public BaseSolver {
       ss.v += v;
       ss.p += ss.v;
     }
-    std::cout << "\tTPS cache size: " << ps2.CacheSize()
-              << "\tHash Conflicts: " << ps2.HashConflicts1()
-              << "\t" << ps2.HashConflicts2() << std::endl;
+    stats::Max("peak_tps_cache_size", ps2.CacheSize());
+    stats::Add("tps_search_hash_conflicts", ps2.HashConflicts1());
+    stats::Add("tps_cache_hash_conflicts", ps2.HashConflicts2());
+    stats::Add("tps_cache_lookups", ps2.CacheLookups());
+    stats::Add("tps_cache_hits", ps2.CacheHits());
+    span.AddArg("cost", std::to_string(sr.size()));
     return sr;
   }
 
@@ -77,13 +85,13 @@ class GreedyLS1 : public BaseSolver {
     auto s1 = SolveI(line, max_time_in_seconds / 2);
     std::reverse(line.begin(), line.end());
     auto s2 = SolveI(line, max_time_in_seconds / 2);
-    s.commands = (s2.empty()                 ? s1
+    s.MutableCommands() = (s2.empty()                 ? s1
                   : s1.empty()               ? s2 
                   : (s1.size() <= s2.size()) ? s1
                                              : s2);
 
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
+              << s.View().size() << std::endl;
     return s;
   }
 };
@@ -3,17 +3,18 @@
 #include "spaceship/map.h"
 #include "spaceship/solvers/base.h"
 #include "spaceship/spaceship.h"
+#include "spaceship/utils/best_first_search.h"
 #include "spaceship/utils/construct_line.h"
 #include "spaceship/utils/drop_dups.h"
+#include "spaceship/utils/line_search.h"
+#include "spaceship/utils/lower_bound.h"
 
-#include "common/hash.h"
-#include "common/heap.h"
 #include "common/solvers/solver.h"
+#include "common/stats/trace.h"
 #include "common/timer.h"
 
 #include <algorithm>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 namespace spaceship {
@@ -22,9 +23,19 @@ class LineSweep1A : public BaseSolver {
   using TBase = BaseSolver;
   using PSolver = TBase::PSolver;
 
+ protected:
+  // Save search state every checkpoint_interval seconds (0 - never).
+  unsigned checkpoint_interval;
+  // Continue search from saved state if it exists.
+  bool resume;
+
  public:
-  LineSweep1A() : BaseSolver() {}
-  explicit LineSweep1A(unsigned _max_time) : BaseSolver(_max_time) {}
+  LineSweep1A() : BaseSolver(), checkpoint_interval(0), resume(false) {}
+  explicit LineSweep1A(unsigned _max_time, unsigned _checkpoint_interval = 0,
+                       bool _resume = false)
+      : BaseSolver(_max_time),
+        checkpoint_interval(_checkpoint_interval),
+        resume(_resume) {}
 
   PSolver Clone() const override {
     return std::make_shared<LineSweep1A>(*this);
@@ -32,171 +43,71 @@ class LineSweep1A : public BaseSolver {
 
   std::string Name() const override { return "ls1a"; }
 
-  // bool SkipSolutionRead() const override { return true; }
+  bool SkipSolutionRead() const override { return resume; }
   // bool SkipBest() const override { return true; }
 
  protected:
-  class Task {
-   public:
-    SpaceShip ss;
-    unsigned covered;
-
-    unsigned cost;
-    unsigned min_final_cost;
-
-    size_t source_hash;
-
-    size_t Hash() const { return HashCombine(ss.Hash(), covered); }
-
-    void ComputeMinFinalCost(const std::vector<I2Point>& line) {
-      unsigned s = 1;
-      if (covered < line.size()) {
-        for (;; ++s) {
-          if (ss.PossibleLocations(s).Inside(line[covered])) break;
-        }
-      }
-      min_final_cost = cost + line.size() - covered + s - 1;
-      // min_final_cost = cost + line.size() - covered;
-    }
-  };
-
-  class TaskInfo {
-   public:
-    size_t hash;
-    unsigned min_final_cost;
-
-    bool operator<(const TaskInfo& r) const {
-      return min_final_cost < r.min_final_cost;
-    }
-  };
+  using TSearch = BestFirstSearch<LineState, LineKey, LineHeuristic>;
 
  public:
-  static std::string SolveI(const std::vector<I2Point>& line,
-                            unsigned max_time_in_seconds) {
+  // checkpoint_id identifies search (problem and direction) for checkpoints.
+  std::string SolveI(const std::vector<I2Point>& line,
+                     unsigned max_time_in_seconds,
+                     const std::string& checkpoint_id) {
+    stats::Span span("SolveI", "solver", [&]() -> stats::Trace::TArgs {
+      return {{"solver", Name()}, {"points", std::to_string(line.size())}};
+    });
     Timer t;
-    std::unordered_map<size_t, Task> tasks;
-    std::vector<HeapMinOnTop<TaskInfo>> vheap;
-    std::string best_s;
-
-    vheap.resize(line.size() + 1);
-    Task task_init;
-    task_init.covered = 0;
-    task_init.cost = 0;
-    task_init.source_hash = 0;
-    auto task_init_hash = task_init.Hash();
-    task_init.ComputeMinFinalCost(line);
-    tasks[task_init_hash] = task_init;
-    vheap[0].Add({task_init_hash, task_init.min_final_cost});
-
-    unsigned best_solution = 10000000;
-    unsigned status = 0;
-    uint64_t hash_conflicts = 0;
-    std::vector<unsigned> best_candidate(vheap.size() + 1, best_solution);
-    for (;;) {
+    LineHeuristic heuristic(line);
+    TSearch search(heuristic);
+    auto checkpoint_file = TSearch::FileName(Name(), checkpoint_id);
+    auto fingerprint = TSearch::Fingerprint(line);
+    if (resume && search.Load(checkpoint_file, fingerprint)) {
+      std::cout << "Resume search " << checkpoint_id << " after "
+                << search.search_time << " seconds" << std::endl;
+    } else {
+      search.Init(LineState());
+    }
+    auto save_checkpoint = [&]() {
+      auto search_time = search.search_time;
+      search.search_time += t.GetSeconds();
+      if (!search.Save(checkpoint_file, fingerprint))
+        std::cout << "Failed to save checkpoint " << checkpoint_file
+                  << std::endl;
+      search.search_time = search_time;
+    };
+
+    unsigned next_checkpoint = checkpoint_interval;
+    auto status = search.Run([&]() -> unsigned {
       if (t.GetSeconds() > max_time_in_seconds) {
         // Time to stop
-        status = 1;
-        break;
+        return 1;
       }
-      if (tasks.size() * 80 > (1ull << 32)) {
-        // Avoid over memory usage
-        status = 2;
-        break;
+      if (checkpoint_interval && (t.GetSeconds() >= next_checkpoint)) {
+        save_checkpoint();
+        next_checkpoint = t.GetSeconds() + checkpoint_interval;
       }
-      for (unsigned i = vheap.size(); i-- > 0;) {
-        best_candidate[i] = std::min<unsigned>(
-            vheap[i].Empty() ? best_solution : vheap[i].Top().min_final_cost,
-            best_candidate[i + 1]);
+      if (OverMemory(search.Counter())) {
+        // Avoid over memory usage
+        return 2;
       }
-      bool done = true;
-      for (unsigned i = 0; i < vheap.size(); ++i) {
-        if (vheap[i].Empty()) continue;
-        if (vheap[i].Top().min_final_cost >= best_solution) {
-          vheap[i].Clear();
-          continue;
-        }
-        if (vheap[i].Top().min_final_cost > best_candidate[i]) {
-          // Let's not spend budget here when exist more promising candidates
-          // with higher coverage
-          continue;
-        }
-        done = false;
-        if (i == line.size()) {
-          // New best solution
-          best_solution = vheap[i].Top().min_final_cost;
-          std::cout << "New best solution with cost " << best_solution
-                    << std::endl;
-          std::string ss;
-          auto t_hash = vheap[i].Top().hash;
-          auto t = &(tasks[t_hash]);
-          if (t->cost != t->min_final_cost) {
-            std::cout << "\tUnexpected cost diff:\t" << t->cost << "\t"
-                      << t->min_final_cost << std::endl;
-          }
-          for (; t->cost > 0;) {
-            auto t2 = &(tasks[t->source_hash]);
-            ss += V2C(t->ss.v - t2->ss.v);
-            t = t2;
-          }
-          std::reverse(ss.begin(), ss.end());
-          best_s = ss;
-          break;
-        }
-
-        auto t_hash = vheap[i].Top().hash;
-        auto t_min_final_cost = vheap[i].Top().min_final_cost;
-        vheap[i].Pop();
-        auto t = tasks[t_hash];
-        if (t.min_final_cost < t_min_final_cost) {
-          // Already processed
-          continue;
-        }
-
-        for (int idx = -1; idx <= 1; ++idx) {
-          for (int idy = -1; idy <= 1; ++idy) {
-            I2Vector idv(idx, idy);
-            Task task_new;
-            task_new.ss.p = t.ss.p + t.ss.v + idv;
-            task_new.ss.v = t.ss.v + idv;
-            task_new.covered = t.covered;
-            if (line[task_new.covered] == task_new.ss.p) {
-              task_new.covered += 1;
-            }
-            task_new.cost = t.cost + 1;
-            task_new.source_hash = t_hash;
-            auto task_new_hash = task_new.Hash();
-            auto it = tasks.find(task_new_hash);
-            if (it == tasks.end()) {
-              task_new.ComputeMinFinalCost(line);
-              if (task_new.min_final_cost < t.min_final_cost) {
-                std::cout << "Min final cost should not decrease." << std::endl;
-              }
-              tasks[task_new_hash] = task_new;
-            } else if (it->second.ss != task_new.ss) {
-              // Hash conflict, skipping
-              ++hash_conflicts;
-              continue;
-            } else if (it->second.cost > task_new.cost) {
-              // Better path to the same point
-              auto d = it->second.cost - task_new.cost;
-              it->second.cost -= d;
-              it->second.min_final_cost -= d;
-              task_new.min_final_cost = it->second.min_final_cost;
-              it->second.source_hash = task_new.source_hash;
-            } else {
-              // Already processed
-              continue;
-            }
-            vheap[task_new.covered].Add(
-                {task_new_hash, task_new.min_final_cost});
-          }
-        }
+      if (RaceStopped()) {
+        // Other solver found optimal solution
+        return 3;
       }
-      if (done) break;
-    }
-    std::cout << "\tStatus = " << status << "\tCashe size = " << tasks.size()
-              << "\tHash conflicts = " << hash_conflicts << std::endl;
-    return best_s;
+      auto race_incumbent =
+          RaceExchange(search.Found() ? int64_t(search.BestSolution()) : -1);
+      if (race_incumbent >= 0) search.SetUpperBound(race_incumbent);
+      return 0;
+    });
+    search.ReportStats();
+    ReportStatus(status);
+    span.AddArg("status", std::to_string(status));
+    if (checkpoint_interval) save_checkpoint();
+    // Lower bound for the given order of points only.
+    if (!search.HashConflicts())
+      stats::Record("line_lower_bound", search.LowerBound());
+    return search.Commands();
   }
 
   Solution Solve(const TProblem& p) override {
@@ -207,16 +118,25 @@ class LineSweep1A : public BaseSolver {
     // Construct line
     auto line = ConstructLine(tvp);
 
+    // Search is restricted to line order, so only generic estimation is a
+    // proven bound for problem.
+    lower_bound = MinMovesLowerBound(tvp);
+
     // Solve
-    auto s1 = SolveI(line, max_time_in_seconds / 2);
-    std::reverse(line.begin(), line.end());
-    auto s2 = SolveI(line, max_time_in_seconds / 2);
-    s.commands = (s2.empty()                 ? s1
+    auto s1 = SolveI(line, max_time_in_seconds / 2, p.Id() + "_0");
+    std::string s2;
+    if (s1.empty() || (int64_t(s1.size()) > lower_bound)) {
+      std::reverse(line.begin(), line.end());
+      s2 = SolveI(line, max_time_in_seconds / 2, p.Id() + "_1");
+    }
+    s.MutableCommands() = (s2.empty()                 ? s1
                   : s1.empty()               ? s2 
                   : (s1.size() <= s2.size()) ? s1
                                              : s2);
+    incumbent = s.Empty() ? -1 : int64_t(s.View().size());
 
-    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.commands.size() << std::endl;
+    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.View().size()
+              << "\tLower bound = " << lower_bound << std::endl;
     return s;
   }
 };
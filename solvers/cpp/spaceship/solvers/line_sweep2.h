@@ -13,8 +13,12 @@
 #include "common/geometry/d2/stl_hash/vector.h"
 #include "common/hash.h"
 #include "common/heap.h"
+#include "common/memory/containers.h"
+#include "common/memory/counter.h"
+#include "common/memory/counting_allocator.h"
 #include "common/numeric/utils/abs.h"
 #include "common/solvers/solver.h"
+#include "common/stats/trace.h"
 #include "common/timer.h"
 #include "common/vector/union.h"
 
@@ -73,6 +77,8 @@ class LineSweep2 : public BaseSolver {
  protected:
   std::vector<std::unordered_map<int64_t, std::vector<int64_t>>> cache_psat;
   uint64_t cache_psat_memory = 0;
+  uint64_t cache_psat_lookups = 0;
+  uint64_t cache_psat_hits = 0;
 
  public:
   std::vector<int64_t> PossibleSpeedAtLocation(int64_t x, int64_t v0, unsigned time) {
@@ -93,6 +99,7 @@ class LineSweep2 : public BaseSolver {
     }
     x -= v0 * time;
     auto it = cache_psat[time].find(x);
+    ++cache_psat_lookups;
     if (it == cache_psat[time].end()) {
       auto v1 = PossibleSpeedAtLocation(x + 1, -1, time - 1);
       auto v2 = PossibleSpeedAtLocation(x, 0, time - 1);
@@ -101,6 +108,8 @@ class LineSweep2 : public BaseSolver {
       cache_psat[time][x] = vu;
       cache_psat_memory += 32 + 8 * vu.size();
       it = cache_psat[time].find(x);
+    } else {
+      ++cache_psat_hits;
     }
     auto vv = it->second;
     for (auto& v : vv) v += v0;
@@ -108,12 +117,20 @@ class LineSweep2 : public BaseSolver {
   }
 
   std::string SolveI(const std::vector<I2Point>& line, unsigned max_time_in_seconds, bool silent = false) {
+    stats::Span span("SolveI", "solver", [&]() -> stats::Trace::TArgs {
+      return {{"solver", Name()}, {"points", std::to_string(line.size())}};
+    });
     Timer t;
-    std::vector<std::unordered_map<I2Vector, Task>> tasks;
-    std::vector<HeapMinOnTop<TaskInfo>> vheap;
+    memory::Counter counter;
+    memory::CountingAllocator<Task> allocator(&counter);
+    std::vector<memory::UnorderedMap<I2Vector, Task>> tasks(
+        line.size() + 1, memory::UnorderedMap<I2Vector, Task>(allocator));
+    memory::LayeredHeapMinOnTop<TaskInfo> vheap(allocator);
+    uint64_t expanded = 0, heap_pushes = 0, heap_pops = 0, table_lookups = 0,
+             table_hits = 0;
+    cache_psat_lookups = cache_psat_hits = 0;
 
-    tasks.resize(line.size() + 1);
-    vheap.resize(line.size());
+    vheap.Resize(line.size());
     Task task_init;
     task_init.v = I2Vector();
     task_init.cost = 0;
@@ -122,11 +139,15 @@ class LineSweep2 : public BaseSolver {
     task_init.final_cost = task_init.cost + task_init.extra;
     if (task_init.extra <= max_steps_between_points) {
       tasks[0][task_init.v] = task_init;
-      vheap[0].Add({task_init.v, task_init.cost, task_init.final_cost});
+      vheap.Add(0, {task_init.v, task_init.cost, task_init.final_cost});
+      ++heap_pushes;
     }
 
     bool solution_exist = false;
     unsigned best_solution = 10000000;
+    // Only solutions better than the best one in race are interesting.
+    auto race_incumbent = RaceExchange(-1);
+    if (race_incumbent >= 0) best_solution = unsigned(race_incumbent);
     I2Vector best_solution_v;
     unsigned status = 0;
     for (;;) {
@@ -135,29 +156,34 @@ class LineSweep2 : public BaseSolver {
         status = 1;
         break;
       }
-      uint64_t memory = 0;
-      for (auto& ti : tasks) memory += 80 * ti.size();
-      for (auto& ti : vheap) memory += 40 * ti.Size();
-      if (memory + cache_psat_memory > (1ull << 32)) {
+      if (OverMemory(counter, cache_psat_memory)) {
         // Avoid over memory usage
         status = 2;
         break;
       }
+      if (RaceStopped()) {
+        // Other solver found optimal solution
+        status = 3;
+        break;
+      }
 
       bool done = true;
-      for (unsigned i = 0; i < vheap.size(); ++i) {
-        if (vheap[i].Empty()) continue;
+      for (unsigned i = vheap.Next(); i < vheap.Layers();
+           i = vheap.Next(i + 1)) {
         // TODO: Improve "line.size() - i - 1" adjustment
-        if (vheap[i].Top().final_cost + line.size() - i - 1 >= best_solution) {
-          vheap[i].Clear();
+        if (vheap.Top(i).final_cost + line.size() - i - 1 >= best_solution) {
+          vheap.Clear(i);
           continue;
         }
         done = false;
-        if (i == vheap.size() - 1) {
+        if (i == vheap.Layers() - 1) {
           // New best solution
           solution_exist = true;
-          best_solution = vheap[i].Top().final_cost;
-          best_solution_v = vheap[i].Top().v;
+          best_solution = vheap.Top(i).final_cost;
+          best_solution_v = vheap.Top(i).v;
+          if (stats::Tracing())
+            stats::Instant("improvement", "search",
+                           {{"cost", std::to_string(best_solution)}});
           if (!silent) {
             std::cout << "New best solution with cost " << best_solution
                       << std::endl;
@@ -165,8 +191,9 @@ class LineSweep2 : public BaseSolver {
           break;
         }
 
-        auto top = vheap[i].Top();
-        vheap[i].Pop();
+        auto top = vheap.Top(i);
+        vheap.Pop(i);
+        ++heap_pops;
         auto t_v = top.v;
         auto t_cost = top.cost;
         auto t = tasks[i][t_v];
@@ -174,6 +201,7 @@ class LineSweep2 : public BaseSolver {
           // Already processed
           continue;
         }
+        ++expanded;
 
         // Add i+1
         SpaceShip ss;
@@ -195,6 +223,7 @@ class LineSweep2 : public BaseSolver {
               for (auto dy : vy) {
                 I2Vector new_v(dx, dy);
                 auto it = tasks[i + 1].find(new_v);
+                ++table_lookups;
                 if (it == tasks[i + 1].end()) {
                   Task task_new;
                   task_new.v = new_v;
@@ -205,16 +234,19 @@ class LineSweep2 : public BaseSolver {
                   task_new.final_cost = task_new.cost + task_new.extra;
                   if (task_new.extra <= max_steps_between_points) {
                     tasks[i + 1][task_new.v] = task_new;
-                    vheap[i + 1].Add({task_new.v, task_new.cost, task_new.final_cost});
+                    vheap.Add(i + 1, {task_new.v, task_new.cost, task_new.final_cost});
+                    ++heap_pushes;
                   }
                 } else {
+                  ++table_hits;
                   if (it->second.cost > t.final_cost) {
                     // Better cost, reset node
                     it->second.vfrom = t.v;
                     it->second.cost = t.final_cost;
                     it->second.extra = it->second.min_extra;
                     it->second.final_cost = it->second.cost + it->second.extra;
-                    vheap[i + 1].Add({it->second.v, it->second.cost, it->second.final_cost});
+                    vheap.Add(i + 1, {it->second.v, it->second.cost, it->second.final_cost});
+                    ++heap_pushes;
                   }
                 }
               }
@@ -226,17 +258,27 @@ class LineSweep2 : public BaseSolver {
         if ((t.extra < max_steps_between_points) && (t.extra < t.min_extra + max_extra)) {
           tasks[i][t_v].extra += 1;
           tasks[i][t_v].final_cost += 1;
-          vheap[i].Add({t.v, t.cost, t.final_cost + 1});
+          vheap.Add(i, {t.v, t.cost, t.final_cost + 1});
+          ++heap_pushes;
         }
       }
       if (done) break;
     }
-    if (!silent) {
-      size_t cache_size = 0, cache_psat_size = 0;
-      for (auto& it : tasks) cache_size += it.size();
+    ReportStatus(status);
+    if (stats::Active()) {
+      size_t table_size = 0, cache_psat_size = 0;
+      for (auto& it : tasks) table_size += it.size();
       for (auto& it : cache_psat) cache_psat_size += it.size();
-      std::cout << "\tStatus = " << status << "\tCashe size = " << cache_size << "\tPSAT cashe size = " << cache_psat_size
-                << std::endl;
+      stats::Add("nodes_expanded", expanded);
+      stats::Add("heap_pushes", heap_pushes);
+      stats::Add("heap_pops", heap_pops);
+      stats::Add("table_lookups", table_lookups);
+      stats::Add("table_hits", table_hits);
+      stats::Add("psat_cache_lookups", cache_psat_lookups);
+      stats::Add("psat_cache_hits", cache_psat_hits);
+      stats::Max("peak_table_size", table_size);
+      stats::Max("peak_psat_cache_size", cache_psat_size);
+      stats::Max("peak_memory_bytes", counter.Peak() + cache_psat_memory);
     }
     
     // Reconstruct solution
@@ -245,7 +287,7 @@ class LineSweep2 : public BaseSolver {
     {
       std::vector<I2Vector> vv;
       auto vcur = best_solution_v;
-      for (unsigned i = vheap.size(); i-- > 0;) {
+      for (unsigned i = vheap.Layers(); i-- > 0;) {
         vv.push_back(vcur);
         vcur = tasks[i][vcur].vfrom;
       }
@@ -314,16 +356,16 @@ class LineSweep2 : public BaseSolver {
     auto s1 = SolveI(line, max_time_in_seconds / 2);
     std::reverse(line.begin(), line.end());
     auto s2 = SolveI(line, max_time_in_seconds / 2);
-    s.commands = (s2.empty()                 ? s1
+    s.MutableCommands() = (s2.empty()                 ? s1
                   : s1.empty()               ? s2
                   : (s1.size() <= s2.size()) ? s1
                                              : s2);
 
     // // Alternative
     // auto line = DropDups(p.GetPoints(), true);
-    // s.commands = SolveI(line, max_time_in_seconds);
+    // s.MutableCommands() = SolveI(line, max_time_in_seconds);
 
-    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.commands.size() << std::endl;
+    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.View().size() << std::endl;
     return s;
   }
 };
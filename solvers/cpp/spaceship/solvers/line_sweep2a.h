@@ -79,17 +79,17 @@ class LineSweep2A : public LineSweep2 {
       std::reverse(line.begin() + 9, line.begin() + 13);
     }
 
-    s.commands = SolveI(line, max_time_in_seconds, true);
+    s.MutableCommands() = SolveI(line, max_time_in_seconds, true);
     std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t"
-              << s.commands.size() << std::endl;
-    if (s.commands.empty()) return s;
+              << s.View().size() << std::endl;
+    if (s.Empty()) return s;
 
     int64_t max_distance = 100;
     if (p.Id() == "18") max_distance = 1000;
 
     for (bool stop = true; !stop;) {
       stop = true;
-      auto best_new = s.commands.size();
+      auto best_new = s.View().size();
       std::string best_s;
       std::string best_mode;
       unsigned best_i, best_j;
@@ -101,7 +101,7 @@ class LineSweep2A : public LineSweep2 {
           std::reverse(line.begin() + i, line.begin() + j + 1);
           auto st = SolveI(line, max_time_in_seconds, true);
           std::reverse(line.begin() + i, line.begin() + j + 1);
-          if (!st.empty() && (st.size() <= s.commands.size())) {
+          if (!st.empty() && (st.size() <= s.View().size())) {
             std::cout << "\tB\t" << i << "\t" << j << "\t" << st.size() << "\t" << DistanceLInf(line[i], line[j]) <<
             std::endl;
             if (st.size() < best_new) {
@@ -115,10 +115,10 @@ class LineSweep2A : public LineSweep2 {
         }
       }
 
-      if (best_new < s.commands.size()) {
+      if (best_new < s.View().size()) {
         stop = false;
-        s.commands = best_s;
-        std::cout << "New best: " << s.commands.size() << std::endl;
+        s.MutableCommands() = best_s;
+        std::cout << "New best: " << s.View().size() << std::endl;
       }
       if (best_mode == "B") {
         std::cout << "Apply modification: B\t" << best_i << "\t" << best_j
@@ -133,7 +133,7 @@ class LineSweep2A : public LineSweep2 {
     //   std::swap(line[i - 1], line[i]);
     //   auto st = SolveI(line, max_time_in_seconds, true);
     //   std::swap(line[i - 1], line[i]);
-    //   if (!st.empty() && (st.size() <= s.commands.size()))
+    //   if (!st.empty() && (st.size() <= s.View().size()))
     //     std::cout << "\tP\t" << i - 1 << "\t" << i << "\t" << st.size() <<
     //     std::endl;
     // }
@@ -145,7 +145,7 @@ class LineSweep2A : public LineSweep2 {
     //     std::swap(line[i], line[j]);
     //     auto st = SolveI(line, max_time_in_seconds, true);
     //     std::swap(line[i], line[j]);
-    //     if (!st.empty() && (st.size() <= s.commands.size()))
+    //     if (!st.empty() && (st.size() <= s.View().size()))
     //       std::cout << "\tP\t" << i << "\t" << j << "\t" << st.size() <<
     //       std::endl;
     //   }
@@ -158,7 +158,7 @@ class LineSweep2A : public LineSweep2 {
     //     std::reverse(line.begin() + i, line.begin() + j);
     //     auto st = SolveI(line, max_time_in_seconds, true);
     //     std::reverse(line.begin() + i, line.begin() + j);
-    //     if (!st.empty() && (st.size() <= s.commands.size()))
+    //     if (!st.empty() && (st.size() <= s.View().size()))
     //       std::cout << "\tB\t" << i << "\t" << j << "\t" << st.size() <<
     //       std::endl;
     //   }
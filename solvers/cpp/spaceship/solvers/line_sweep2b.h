@@ -57,13 +57,13 @@ class LineSweep2B : public LineSweep2 {
       // if (pl.Load(p.Id(), "../../problems/spaceship_lkh_max/spaceship" + p.Id() + ".txt" + ((i >= 0) ? (".v" + std::to_string(i)) : ""))) {
         auto line = DropDups(pl.GetPoints(), true);
         auto st = SolveI(line, max_time_in_seconds);
-        if (!st.empty() && (s.commands.empty() || (s.commands.size() > st.size()))) {
-          s.commands = st;
+        if (!st.empty() && (s.Empty() || (s.View().size() > st.size()))) {
+          s.MutableCommands() = st;
         }
       }
     }
 
-    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.commands.size() << std::endl;
+    std::cout << p.Id() << "\t" << p.GetPoints().size() << "\t" << s.View().size() << std::endl;
     return s;
   }
 };
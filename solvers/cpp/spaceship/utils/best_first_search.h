@@ -0,0 +1,398 @@
+#pragma once
+
+#include "spaceship/map.h"
+#include "spaceship/spaceship.h"
+
+#include "common/base.h"
+#include "common/files/binary_stream.h"
+#include "common/geometry/d2/point.h"
+#include "common/hash.h"
+#include "common/memory/containers.h"
+#include "common/memory/counter.h"
+#include "common/memory/counting_allocator.h"
+#include "common/stats/perf_counters.h"
+#include "common/stats/registry.h"
+#include "common/stats/trace.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace spaceship {
+// Best-first (A*) search over spaceship states, moves are 9 accelerations.
+// Used by DP, LineSweep1 solvers and TwoPointsSolver, problem specific part
+// is provided by template parameters:
+//   TState     -- SpaceShip ss and payload (points left, covered, ...).
+//                 size_t Memory() const -- bytes allocated by payload.
+//                 Write/Read for checkpoints (only if Save/Load are used).
+//   TKeyPolicy -- static size_t Hash(const TState&) and
+//                 static bool Same(const TState&, const TState&) to detect
+//                 hash conflicts.
+//   THeuristic -- unsigned Layers() const, unsigned Layer(const TState&),
+//                 bool Move(const TState& from, TState& to) -- updates
+//                 payload after to.ss was set, false to skip move,
+//                 unsigned MinExtraCost(const TState&, bool& exact) --
+//                 admissible estimation of remaining moves, exact is true
+//                 for states with known remaining cost (solution found).
+//   TFrontier  -- layered priority queue (see heap::ext::LayeredHeap).
+// Search expands layers with the best candidate among layers with the same
+// or higher index only, let's not spend budget on other layers.
+template <class TTState, class TTKeyPolicy, class TTHeuristic,
+          template <class> class TTFrontier = memory::LayeredHeapMinOnTop>
+class BestFirstSearch {
+ public:
+  using TState = TTState;
+  using TKeyPolicy = TTKeyPolicy;
+  using THeuristic = TTHeuristic;
+
+  static constexpr uint32_t magic = 0x50435353;  // "SSCP"
+  static constexpr uint32_t version = 3;
+
+  class Task {
+   public:
+    TState state;
+    unsigned cost;
+    unsigned min_final_cost;
+    size_t source_hash;
+    bool final;
+
+    void Write(files::BinaryWriter& w) const {
+      state.Write(w);
+      w.Write(cost);
+      w.Write(min_final_cost);
+      w.Write(source_hash);
+      w.Write(final);
+    }
+
+    void Read(files::BinaryReader& r) {
+      state.Read(r);
+      r.Read(cost);
+      r.Read(min_final_cost);
+      r.Read(source_hash);
+      r.Read(final);
+    }
+  };
+
+  class TaskInfo {
+   public:
+    size_t hash;
+    unsigned min_final_cost;
+
+    bool operator<(const TaskInfo& r) const {
+      return min_final_cost < r.min_final_cost;
+    }
+  };
+
+  using TFrontier = TTFrontier<TaskInfo>;
+
+ protected:
+  const THeuristic& heuristic;
+  // Memory used by tasks and vheap.
+  memory::Counter counter;
+  memory::UnorderedMap<size_t, Task> tasks;
+  TFrontier vheap;
+  unsigned best_solution = 10000000;
+  size_t best_hash = 0;
+  bool found = false;
+  uint64_t hash_conflicts = 0;
+  // Smallest min_final_cost among states skipped because of hash conflicts.
+  unsigned conflicts_bound = 10000000;
+  bool verbose;
+  // Work counters since Init or Load, not stored in checkpoints.
+  uint64_t expanded = 0;
+  uint64_t heap_pushes = 0;
+  uint64_t heap_pops = 0;
+  uint64_t table_lookups = 0;
+  uint64_t table_hits = 0;
+  // Hardware counters for hot regions, active only in bench with -bench_perf.
+  stats::PerfSampler heap_pop_sampler{"heap_pop"};
+  stats::PerfSampler table_probe_sampler{"table_probe"};
+
+ public:
+  // Total search time in seconds over all runs, including previous ones.
+  // Maintained by caller, stored in checkpoints.
+  uint64_t search_time = 0;
+
+ public:
+  explicit BestFirstSearch(const THeuristic& _heuristic, bool _verbose = true)
+      : heuristic(_heuristic),
+        tasks(memory::CountingAllocator<Task>(&counter)),
+        vheap(memory::CountingAllocator<TaskInfo>(&counter)),
+        verbose(_verbose) {}
+
+  // Containers keep pointer to counter.
+  BestFirstSearch(const BestFirstSearch&) = delete;
+  BestFirstSearch& operator=(const BestFirstSearch&) = delete;
+
+  void Init(const TState& state) {
+    for (auto& it : tasks) counter.Deallocate(it.second.state.Memory());
+    tasks.clear();
+    vheap.Resize(heuristic.Layers());
+    best_solution = 10000000;
+    best_hash = 0;
+    found = false;
+    hash_conflicts = 0;
+    conflicts_bound = 10000000;
+    search_time = 0;
+    ResetWorkCounters();
+    Task task_init;
+    task_init.state = state;
+    task_init.cost = 0;
+    task_init.source_hash = 0;
+    // Initial state is never final even if its remaining cost is exact:
+    // path has to contain at least one move, empty commands are not a
+    // solution and TwoPointsSolver takes the first move of the path.
+    bool exact;
+    task_init.min_final_cost = heuristic.MinExtraCost(task_init.state, exact);
+    task_init.final = false;
+    auto task_init_hash = TKeyPolicy::Hash(task_init.state);
+    counter.Allocate(task_init.state.Memory());
+    vheap.Add(heuristic.Layer(task_init.state),
+              {task_init_hash, task_init.min_final_cost});
+    ++heap_pushes;
+    tasks.emplace(task_init_hash, std::move(task_init));
+  }
+
+  // Solutions with cost >= upper_bound are ignored.
+  void SetUpperBound(unsigned upper_bound) {
+    best_solution = std::min(best_solution, upper_bound);
+  }
+
+  const memory::Counter& Counter() const { return counter; }
+  size_t Size() const { return tasks.size(); }
+  uint64_t HashConflicts() const { return hash_conflicts; }
+  bool Found() const { return found; }
+  unsigned BestSolution() const { return best_solution; }
+
+  // Adds work counters to stats of current thread, table size is peak one
+  // (tasks are never removed).
+  void ReportStats() const {
+    if (!stats::Active()) return;
+    stats::Add("nodes_expanded", expanded);
+    stats::Add("heap_pushes", heap_pushes);
+    stats::Add("heap_pops", heap_pops);
+    stats::Add("table_lookups", table_lookups);
+    stats::Add("table_hits", table_hits);
+    stats::Add("hash_conflicts", hash_conflicts);
+    stats::Max("peak_table_size", tasks.size());
+    stats::Max("peak_memory_bytes", counter.Peak());
+    heap_pop_sampler.Report();
+    table_probe_sampler.Report();
+  }
+
+  // Every state that is not expanded yet is in vheap or was skipped on hash
+  // conflict and min_final_cost is admissible, so the smallest one is a lower
+  // bound (for heuristics that don't prune moves).
+  unsigned LowerBound() const {
+    auto r = std::min(best_solution, conflicts_bound);
+    return vheap.Empty() ? r
+                         : std::min(r, vheap.Top(vheap.Best()).min_final_cost);
+  }
+
+  // Calls stop() before every round, stop returns non-zero status to
+  // interrupt search. Returns 0 if search is finished.
+  template <class TStop>
+  unsigned Run(TStop stop) {
+    for (;;) {
+      auto status = stop();
+      if (status) return status;
+      if (!Round()) return 0;
+    }
+  }
+
+  // Expands the best task from every selected layer.
+  // Returns false if there is nothing to expand.
+  bool Round() {
+    bool done = true;
+    for (unsigned i = vheap.Best(); i < vheap.Layers();
+         i = vheap.Best(i + 1)) {
+      if (vheap.Top(i).min_final_cost >= best_solution) {
+        // Candidates from this and next layers can't improve best solution
+        for (unsigned j = i; j < vheap.Layers(); j = vheap.Next(j + 1))
+          vheap.Clear(j);
+        break;
+      }
+      done = false;
+      heap_pop_sampler.Begin();
+      auto info = vheap.Top(i);
+      vheap.Pop(i);
+      heap_pop_sampler.End();
+      ++heap_pops;
+      Expand(info);
+    }
+    return !done;
+  }
+
+  // Tasks from initial state to best solution.
+  std::vector<const Task*> Path() const {
+    std::vector<const Task*> path;
+    if (!found) return path;
+    auto t = &(tasks.find(best_hash)->second);
+    for (path.push_back(t); t->cost > 0; path.push_back(t))
+      t = &(tasks.find(t->source_hash)->second);
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+  std::string Commands() const {
+    std::string s;
+    auto path = Path();
+    for (unsigned i = 1; i < path.size(); ++i)
+      s += V2C(path[i]->state.ss.v - path[i - 1]->state.ss.v);
+    return s;
+  }
+
+ protected:
+  void ResetWorkCounters() {
+    expanded = heap_pushes = heap_pops = table_lookups = table_hits = 0;
+    heap_pop_sampler.Reset();
+    table_probe_sampler.Reset();
+  }
+
+  void Expand(const TaskInfo& info) {
+    // References to unordered_map elements are stable during insertions.
+    const auto& t = tasks.find(info.hash)->second;
+    if (t.min_final_cost < info.min_final_cost) {
+      // Already processed
+      return;
+    }
+    ++expanded;
+    for (int idx = -1; idx <= 1; ++idx) {
+      for (int idy = -1; idy <= 1; ++idy) {
+        I2Vector idv(idx, idy);
+        Task task_new;
+        task_new.state.ss.v = t.state.ss.v + idv;
+        task_new.state.ss.p = t.state.ss.p + task_new.state.ss.v;
+        if (!heuristic.Move(t.state, task_new.state)) continue;
+        task_new.cost = t.cost + 1;
+        task_new.source_hash = info.hash;
+        auto task_new_hash = TKeyPolicy::Hash(task_new.state);
+        table_probe_sampler.Begin();
+        auto it = tasks.find(task_new_hash);
+        table_probe_sampler.End();
+        ++table_lookups;
+        if (it == tasks.end()) {
+          task_new.min_final_cost =
+              task_new.cost +
+              heuristic.MinExtraCost(task_new.state, task_new.final);
+          counter.Allocate(task_new.state.Memory());
+          it = tasks.emplace(task_new_hash, std::move(task_new)).first;
+        } else if (!TKeyPolicy::Same(it->second.state, task_new.state)) {
+          // Hash conflict, skipping
+          ++hash_conflicts;
+          bool exact;
+          conflicts_bound = std::min(
+              conflicts_bound,
+              task_new.cost + heuristic.MinExtraCost(task_new.state, exact));
+          continue;
+        } else if (it->second.cost > task_new.cost) {
+          // Better path to the same state
+          ++table_hits;
+          auto d = it->second.cost - task_new.cost;
+          it->second.cost -= d;
+          it->second.min_final_cost -= d;
+          it->second.source_hash = task_new.source_hash;
+        } else {
+          // Already processed
+          ++table_hits;
+          continue;
+        }
+        auto& tn = it->second;
+        if (!tn.final) {
+          vheap.Add(heuristic.Layer(tn.state),
+                    {task_new_hash, tn.min_final_cost});
+          ++heap_pushes;
+        } else if (tn.min_final_cost < best_solution) {
+          // New best solution
+          best_solution = tn.min_final_cost;
+          best_hash = task_new_hash;
+          found = true;
+          // Inner searches (verbose = false) are too frequent for timeline.
+          if (verbose) {
+            std::cout << "New best solution with cost " << best_solution
+                      << std::endl;
+            stats::Instant("improvement", "search",
+                           [&]() -> stats::Trace::TArgs {
+                             return {{"cost", std::to_string(best_solution)}};
+                           });
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static std::string FileName(const std::string& solver_name,
+                              const std::string& id) {
+    return "../../checkpoints/spaceship/" + solver_name + "/" + id + ".bin";
+  }
+
+  // Used to detect that checkpoint was created for different input.
+  static uint64_t Fingerprint(const std::vector<I2Point>& vp) {
+    size_t h = vp.size();
+    for (auto& p : vp) h = HashCombine(HashCombine(h, p.x), p.y);
+    return h;
+  }
+
+  bool Save(const std::string& filename, uint64_t fingerprint) const {
+    std::error_code ec;
+    std::filesystem::create_directories(
+        std::filesystem::path(filename).parent_path(), ec);
+    files::BinaryWriter w(filename);
+    if (!w.Good()) return false;
+    w.Write(magic);
+    w.Write(version);
+    w.Write(fingerprint);
+    w.Write(best_solution);
+    w.Write(best_hash);
+    w.Write(found);
+    w.Write(hash_conflicts);
+    w.Write(conflicts_bound);
+    w.Write(search_time);
+    w.Write<uint64_t>(tasks.size());
+    for (auto& it : tasks) {
+      w.Write(it.first);
+      it.second.Write(w);
+    }
+    w.Write<uint64_t>(vheap.Layers());
+    for (unsigned i = 0; i < vheap.Layers(); ++i)
+      w.WriteVector(vheap.Layer(i).Data());
+    return w.Close();
+  }
+
+  // On failure search state is undefined, call Init after it.
+  bool Load(const std::string& filename, uint64_t fingerprint) {
+    files::BinaryReader r(filename);
+    if (!r.Good()) return false;
+    if ((r.Read<uint32_t>() != magic) || (r.Read<uint32_t>() != version) ||
+        (r.Read<uint64_t>() != fingerprint))
+      return false;
+    r.Read(best_solution);
+    r.Read(best_hash);
+    r.Read(found);
+    r.Read(hash_conflicts);
+    r.Read(conflicts_bound);
+    r.Read(search_time);
+    ResetWorkCounters();
+    tasks.clear();
+    auto ntasks = r.Read<uint64_t>();
+    tasks.reserve(ntasks);
+    for (uint64_t i = 0; i < ntasks; ++i) {
+      auto hash = r.Read<size_t>();
+      auto& task = tasks[hash];
+      task.Read(r);
+      counter.Allocate(task.state.Memory());
+    }
+    vheap.Resize(r.Read<uint64_t>());
+    std::vector<TaskInfo> v;
+    for (unsigned i = 0; i < vheap.Layers(); ++i) {
+      r.ReadVector(v);
+      vheap.Assign(i, typename TFrontier::THeap(v, vheap.Allocator()));
+    }
+    return r.Good();
+  }
+};
+}  // namespace spaceship
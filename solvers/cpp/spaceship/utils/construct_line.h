@@ -2,11 +2,12 @@
 
 #include "common/geometry/d2/distance/distance_l1.h"
 #include "common/geometry/d2/point.h"
+#include "common/stats/registry.h"
+#include "common/stats/trace.h"
 #include "common/timer.h"
 #include "common/vector/enumerate.h"
 
 #include <algorithm>
-#include <iostream>
 #include <vector>
 #include <utility>
 
@@ -15,8 +16,10 @@ namespace spaceship {
 //   Add faster algorithm for P23 and P25.
 //   Current algorithm O(N^2).
 static std::vector<I2Point> ConstructLine(const std::vector<I2Point>& vp) {
+  stats::Span span("ConstructLine", "solver", [&]() -> stats::Trace::TArgs {
+    return {{"points", std::to_string(vp.size())}};
+  });
   Timer t;
-  std::cout << "Constructing line...";
   std::vector<std::vector<unsigned>> vlines;
   std::vector<unsigned> index = nvector::Enumerate<unsigned>(0u, vp.size());
   std::vector<unsigned> status(vp.size(), 3);
@@ -60,7 +63,7 @@ static std::vector<I2Point> ConstructLine(const std::vector<I2Point>& vp) {
     vlines.pop_back();
   }
 
-  std::cout << "\tDone.\tTime = " << t.GetMilliseconds() << std::endl;
+  stats::Record("construct_line_ms", t.GetMilliseconds());
   std::vector<I2Point> output;
   for (auto u : vlines[0]) output.push_back(vp[u]);
   return output;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "spaceship/spaceship.h"
+
+#include "common/base.h"
+#include "common/files/binary_stream.h"
+#include "common/geometry/d2/point.h"
+#include "common/hash.h"
+
+#include <vector>
+
+namespace spaceship {
+// BestFirstSearch parts for visiting points in the given order (LineSweep1).
+class LineState {
+ public:
+  SpaceShip ss;
+  unsigned covered = 0;
+
+  size_t Memory() const { return 0; }
+
+  void Write(files::BinaryWriter& w) const {
+    w.Write(ss);
+    w.Write(covered);
+  }
+
+  void Read(files::BinaryReader& r) {
+    r.Read(ss);
+    r.Read(covered);
+  }
+};
+
+class LineKey {
+ public:
+  static size_t Hash(const LineState& s) {
+    return HashCombine(s.ss.Hash(), s.covered);
+  }
+
+  static bool Same(const LineState& l, const LineState& r) {
+    return (l.ss == r.ss) && (l.covered == r.covered);
+  }
+};
+
+class LineHeuristic {
+ protected:
+  const std::vector<I2Point>& line;
+
+ public:
+  explicit LineHeuristic(const std::vector<I2Point>& _line) : line(_line) {}
+
+  unsigned Layers() const { return line.size() + 1; }
+  unsigned Layer(const LineState& s) const { return s.covered; }
+
+  bool Move(const LineState& from, LineState& to) const {
+    to.covered = from.covered;
+    // Fully covered (or empty) line has nothing to visit.
+    if ((from.covered < line.size()) && (line[from.covered] == to.ss.p))
+      ++to.covered;
+    return true;
+  }
+
+  unsigned MinExtraCost(const LineState& s, bool& exact) const {
+    exact = (s.covered == line.size());
+    if (exact) return 0;
+    unsigned k = 1;
+    for (; !s.ss.PossibleLocations(k).Inside(line[s.covered]);) ++k;
+    return line.size() - s.covered + k - 1;
+  }
+};
+}  // namespace spaceship
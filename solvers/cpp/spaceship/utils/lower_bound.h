@@ -0,0 +1,36 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/geometry/d2/point.h"
+#include "common/numeric/utils/abs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace spaceship {
+// Lower bound on number of moves to visit all points starting from origin
+// with zero speed. Point p can't be visited before step s(p), where s(p) is
+// the smallest s with max(|x|, |y|) <= s(s+1)/2, and every step visits at
+// most one point, so answer >= s + #{p : s(p) > s} for every s.
+// Same estimation as DP2 uses for initial task.
+// Expects points without duplicates and without origin (see DropDups).
+static unsigned MinMovesLowerBound(const std::vector<I2Point>& vp) {
+  std::vector<unsigned> vs;
+  vs.reserve(vp.size());
+  for (auto& p : vp) {
+    auto d = std::max(Abs(p.x), Abs(p.y));
+    auto s = unsigned(std::sqrt(2.0 * d));
+    for (; (s > 0) && ((int64_t(s) * (s - 1)) / 2 >= d);) --s;
+    for (; (int64_t(s) * (s + 1)) / 2 < d;) ++s;
+    vs.push_back(s);
+  }
+  std::sort(vs.begin(), vs.end());
+  unsigned r = vs.size();
+  for (unsigned i = 0; i < vs.size(); ++i) {
+    if ((i + 1 == vs.size()) || (vs[i] != vs[i + 1]))
+      r = std::max<unsigned>(r, vs[i] + (vs.size() - i - 1));
+  }
+  return r;
+}
+}  // namespace spaceship
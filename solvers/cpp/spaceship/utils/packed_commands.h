@@ -0,0 +1,159 @@
+#pragma once
+
+#include "common/base.h"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace spaceship {
+// Compact binary form of commands, only '1'..'9' are supported.
+// Header: magic, version, encoding, number of commands and FNV-1a checksum of
+// commands (little-endian, like checkpoints). Payload is one of:
+//   NIBBLES -- two commands per byte, first one in low half;
+//   RLE     -- one byte per run, (command - '1') | ((run_length - 1) << 4).
+// Encoder builds both payloads while commands are appended and keeps the
+// shorter one.
+class CommandsEncoder {
+ public:
+  static constexpr uint32_t magic = 0x4b505353;  // "SSPK"
+  static constexpr uint32_t version = 1;
+  static constexpr size_t header_size = 28;
+  static constexpr size_t max_run = 16;
+
+  enum Encoding : uint32_t { NIBBLES = 0, RLE = 1 };
+
+  static uint64_t ChecksumInit() { return 14695981039346656037ull; }
+  static uint64_t ChecksumUpdate(uint64_t h, char c) {
+    return (h ^ uint8_t(c)) * 1099511628211ull;
+  }
+
+ protected:
+  std::vector<uint8_t> nibbles;
+  std::vector<uint8_t> rle;
+  uint64_t size = 0;
+  uint64_t checksum = ChecksumInit();
+  uint8_t last = 0;
+  size_t run = 0;
+
+  static bool Supported(char c) { return (c >= '1') && (c <= '9'); }
+
+ public:
+  CommandsEncoder() {}
+  explicit CommandsEncoder(size_t expected_size) { Reserve(expected_size); }
+
+  // Avoids reallocations for up to expected_size commands.
+  void Reserve(size_t expected_size) {
+    nibbles.reserve((expected_size + 1) / 2);
+    rle.reserve(expected_size);
+  }
+
+  uint64_t Size() const { return size; }
+
+  // Returns false (encoder is not changed) for unsupported command.
+  bool Push(char c) {
+    if (!Supported(c)) return false;
+    uint8_t i = uint8_t(c - '1');
+    if (size & 1)
+      nibbles.back() |= uint8_t(i << 4);
+    else
+      nibbles.push_back(i);
+    if (run && (i == last) && (run < max_run)) {
+      rle.back() += 0x10;
+      ++run;
+    } else {
+      rle.push_back(i);
+      last = i;
+      run = 1;
+    }
+    checksum = ChecksumUpdate(checksum, c);
+    ++size;
+    return true;
+  }
+
+  // Returns false (encoder is not changed) if commands contain anything
+  // other than '1'..'9'.
+  bool Append(std::string_view commands) {
+    for (auto c : commands) {
+      if (!Supported(c)) return false;
+    }
+    for (auto c : commands) Push(c);
+    return true;
+  }
+
+  // Header and the shortest payload.
+  std::string Finish() const {
+    bool use_rle = (rle.size() < nibbles.size());
+    auto& payload = use_rle ? rle : nibbles;
+    std::string output(header_size + payload.size(), 0);
+    char* p = &output[0];
+    uint32_t encoding = use_rle ? RLE : NIBBLES;
+    std::memcpy(p, &magic, 4);
+    std::memcpy(p + 4, &version, 4);
+    std::memcpy(p + 8, &encoding, 4);
+    std::memcpy(p + 12, &size, 8);
+    std::memcpy(p + 20, &checksum, 8);
+    if (!payload.empty())
+      std::memcpy(p + header_size, payload.data(), payload.size());
+    return output;
+  }
+
+  // Returns false (output is not changed) if commands contain anything
+  // other than '1'..'9'.
+  static bool Encode(std::string_view commands, std::string& output) {
+    CommandsEncoder e(commands.size());
+    if (!e.Append(commands)) return false;
+    output = e.Finish();
+    return true;
+  }
+
+  // Text solutions consist of digits only, so magic can't be there.
+  static bool IsPacked(std::string_view data) {
+    uint32_t m = 0;
+    if (data.size() < header_size) return false;
+    std::memcpy(&m, data.data(), 4);
+    return m == magic;
+  }
+
+  // Returns false for corrupted data (commands are cleared).
+  static bool Decode(std::string_view data, std::string& commands) {
+    commands.clear();
+    if (!IsPacked(data)) return false;
+    uint32_t v, encoding;
+    uint64_t n, expected_checksum;
+    std::memcpy(&v, data.data() + 4, 4);
+    std::memcpy(&encoding, data.data() + 8, 4);
+    std::memcpy(&n, data.data() + 12, 8);
+    std::memcpy(&expected_checksum, data.data() + 20, 8);
+    if (v != version) return false;
+    auto payload = data.substr(header_size);
+    if (encoding == NIBBLES) {
+      if (payload.size() != (n + 1) / 2) return false;
+      commands.resize(n);
+      for (uint64_t i = 0; i < n; ++i)
+        commands[i] =
+            char('1' + ((uint8_t(payload[i / 2]) >> (4 * (i & 1))) & 15));
+    } else if (encoding == RLE) {
+      if ((payload.size() > n) || (n > payload.size() * max_run))
+        return false;
+      commands.reserve(n);
+      for (auto b : payload)
+        commands.append((uint8_t(b) >> 4) + 1, char('1' + (uint8_t(b) & 15)));
+      if (commands.size() != n) {
+        commands.clear();
+        return false;
+      }
+    } else {
+      return false;
+    }
+    uint64_t h = ChecksumInit();
+    for (auto c : commands) h = ChecksumUpdate(h, c);
+    if (h != expected_checksum) {
+      commands.clear();
+      return false;
+    }
+    return true;
+  }
+};
+}  // namespace spaceship
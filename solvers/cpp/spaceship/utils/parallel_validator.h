@@ -0,0 +1,145 @@
+#pragma once
+
+#include "spaceship/map.h"
+#include "spaceship/spaceship.h"
+#include "spaceship/utils/point_index.h"
+
+#include "common/base.h"
+#include "common/geometry/d2/point.h"
+#include "common/geometry/d2/vector.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace spaceship {
+// Checks that commands visit all points.
+// Velocity and position are prefix sums of command deltas, so commands are
+// split into chunks and every chunk computes its velocity change and
+// displacement from zero state independently (branch free, vectorizable).
+// Chunk start states are combined sequentially, after that every chunk is
+// replayed from its start state in own thread.
+class ParallelValidator {
+ public:
+  // Smaller inputs are not worth a thread.
+  static constexpr size_t min_chunk_size = (1u << 18);
+
+ protected:
+  class ChunkSum {
+   public:
+    I2Vector dv;
+    // Position change for zero initial velocity.
+    I2Vector dp;
+  };
+
+  static bool AllCommandsValid(std::string_view commands) {
+    size_t invalid = 0;
+    for (auto c : commands) invalid += ((c < '1') || (c > '9')) ? 1 : 0;
+    return invalid == 0;
+  }
+
+  // i / 3 for i in [0, 8] is (i * 11) >> 5.
+  static ChunkSum Sum(const char* s, size_t size) {
+    const size_t block_size = 256;
+    int64_t sx = 0, sy = 0, wx = 0, wy = 0;
+    for (size_t b = 0; b < size; b += block_size) {
+      auto bsize = std::min(block_size, size - b);
+      int32_t bsx = 0, bsy = 0, bwx = 0, bwy = 0;
+      for (size_t k = 0; k < bsize; ++k) {
+        int32_t i = s[b + k] - '1';
+        int32_t i3 = (i * 11) >> 5;
+        int32_t dx = i - 3 * i3 - 1, dy = i3 - 1;
+        bsx += dx;
+        bsy += dy;
+        bwx += int32_t(k) * dx;
+        bwy += int32_t(k) * dy;
+      }
+      sx += bsx;
+      sy += bsy;
+      wx += int64_t(b) * bsx + bwx;
+      wy += int64_t(b) * bsy + bwy;
+    }
+    // Delta k affects positions after moves k..size-1.
+    return {{sx, sy}, {int64_t(size) * sx - wx, int64_t(size) * sy - wy}};
+  }
+
+  static void Replay(const char* s, size_t size, SpaceShip ss,
+                     const PointIndex& index, std::vector<uint8_t>& visited) {
+    for (size_t k = 0; k < size; ++k) {
+      int64_t i = s[k] - '1';
+      int64_t i3 = (i * 11) >> 5;
+      ss.v.dx += i - 3 * i3 - 1;
+      ss.v.dy += i3 - 1;
+      ss.p += ss.v;
+      auto j = index.Find(ss.p);
+      if (j >= 0) visited[j] = 1;
+    }
+  }
+
+ public:
+  // Reference implementation, one command at a time.
+  static bool ValidSimple(const std::vector<I2Point>& vp,
+                          std::string_view commands) {
+    PointIndex index(vp);
+    std::vector<uint8_t> visited(index.Size(), 0);
+    SpaceShip ss;
+    for (auto c : std::string("5").append(commands)) {
+      ss.ApplyCommand(c);
+      auto j = index.Find(ss.p);
+      if (j >= 0) visited[j] = 1;
+    }
+    return std::count(visited.begin(), visited.end(), 0) == 0;
+  }
+
+  // nthreads = 0 -- use all hardware threads.
+  static bool Valid(const std::vector<I2Point>& vp, std::string_view commands,
+                    unsigned nthreads = 0) {
+    if (!AllCommandsValid(commands)) return ValidSimple(vp, commands);
+    PointIndex index(vp);
+    if (!nthreads) nthreads = std::max(1u, std::thread::hardware_concurrency());
+    size_t nchunks = std::min<size_t>(
+        nthreads, (commands.size() + min_chunk_size - 1) / min_chunk_size);
+    nchunks = std::max<size_t>(nchunks, 1);
+    std::vector<size_t> vb(nchunks + 1);
+    for (size_t i = 0; i <= nchunks; ++i)
+      vb[i] = (commands.size() * i) / nchunks;
+    const char* s = commands.data();
+
+    // Level 1: chunk sums.
+    std::vector<ChunkSum> sums(nchunks);
+    auto run = [&](auto f) {
+      std::vector<std::thread> threads;
+      for (size_t i = 1; i < nchunks; ++i) threads.emplace_back(f, i);
+      f(0);
+      for (auto& t : threads) t.join();
+    };
+    if (nchunks > 1)
+      run([&](size_t i) { sums[i] = Sum(s + vb[i], vb[i + 1] - vb[i]); });
+
+    // Level 2: chunk start states and replay.
+    std::vector<SpaceShip> starts(nchunks);
+    for (size_t i = 1; i < nchunks; ++i) {
+      auto& ss = starts[i - 1];
+      auto size = int64_t(vb[i] - vb[i - 1]);
+      starts[i].v = ss.v + sums[i - 1].dv;
+      starts[i].p = ss.p + ss.v * size + sums[i - 1].dp;
+    }
+    std::vector<std::vector<uint8_t>> visited(
+        nchunks, std::vector<uint8_t>(index.Size(), 0));
+    // Initial "5" command keeps ship at origin.
+    auto j = index.Find(I2Point());
+    if (j >= 0) visited[0][j] = 1;
+    run([&](size_t i) {
+      Replay(s + vb[i], vb[i + 1] - vb[i], starts[i], index, visited[i]);
+    });
+    for (unsigned k = 0; k < index.Size(); ++k) {
+      bool v = false;
+      for (auto& vv : visited) v = v || vv[k];
+      if (!v) return false;
+    }
+    return true;
+  }
+};
+}  // namespace spaceship
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common/base.h"
+#include "common/geometry/d2/point.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace spaceship {
+// Static set of points with O(1) lookup of point index.
+// Flat open addressing table over sorted unique points, lookups outside of
+// bounding box are rejected before hashing.
+class PointIndex {
+ protected:
+  std::vector<I2Point> points;
+  std::vector<int> table;
+  uint64_t mask = 0;
+  I2Point pmin, pmax;
+
+ public:
+  explicit PointIndex(const std::vector<I2Point>& vp) : points(vp) {
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+    if (points.empty()) return;
+    pmin = pmax = points[0];
+    for (auto& p : points) {
+      pmin.x = std::min(pmin.x, p.x);
+      pmin.y = std::min(pmin.y, p.y);
+      pmax.x = std::max(pmax.x, p.x);
+      pmax.y = std::max(pmax.y, p.y);
+    }
+    uint64_t size = 16;
+    for (; size < 2 * points.size();) size *= 2;
+    mask = size - 1;
+    table.assign(size, -1);
+    for (unsigned i = 0; i < points.size(); ++i) {
+      auto h = Hash(points[i]);
+      for (; table[h] >= 0;) h = (h + 1) & mask;
+      table[h] = int(i);
+    }
+  }
+
+  unsigned Size() const { return points.size(); }
+  const std::vector<I2Point>& Points() const { return points; }
+
+  // Index of point in Points(), -1 if it's not in set.
+  int Find(const I2Point& p) const {
+    if (points.empty()) return -1;
+    if ((p.x < pmin.x) || (p.x > pmax.x) || (p.y < pmin.y) || (p.y > pmax.y))
+      return -1;
+    for (auto h = Hash(p);; h = (h + 1) & mask) {
+      auto i = table[h];
+      if ((i < 0) || (points[i] == p)) return i;
+    }
+  }
+
+ protected:
+  uint64_t Hash(const I2Point& p) const {
+    auto h = uint64_t(p.x) * 0x9E3779B97F4A7C15ull ^
+             uint64_t(p.y) * 0xC2B2AE3D27D4EB4Full;
+    return (h ^ (h >> 29)) & mask;
+  }
+};
+}  // namespace spaceship
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "spaceship/spaceship.h"
+
+#include "common/base.h"
+#include "common/files/binary_stream.h"
+#include "common/geometry/d2/point.h"
+#include "common/hash.h"
+#include "common/stl/hash/vector.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace spaceship {
+// BestFirstSearch parts for visiting points in any order (DP2).
+class PointsState {
+ public:
+  SpaceShip ss;
+  // Indices of points that are not visited yet.
+  std::vector<uint16_t> vp;
+
+  size_t Memory() const { return vp.capacity() * sizeof(uint16_t); }
+
+  void Write(files::BinaryWriter& w) const {
+    w.Write(ss);
+    w.WriteVector(vp);
+  }
+
+  void Read(files::BinaryReader& r) {
+    r.Read(ss);
+    r.ReadVector(vp);
+  }
+};
+
+class PointsKey {
+ public:
+  static size_t Hash(const PointsState& s) {
+    return HashCombine(s.ss.Hash(), std::hash<std::vector<uint16_t>>{}(s.vp));
+  }
+
+  static bool Same(const PointsState& l, const PointsState& r) {
+    return (l.ss == r.ss) && (l.vp == r.vp);
+  }
+};
+
+class PointsHeuristic {
+ protected:
+  const std::vector<I2Point>& tvp;
+
+ public:
+  explicit PointsHeuristic(const std::vector<I2Point>& _tvp) : tvp(_tvp) {}
+
+  unsigned Layers() const { return tvp.size() + 1; }
+  unsigned Layer(const PointsState& s) const {
+    return tvp.size() - s.vp.size();
+  }
+
+  bool Move(const PointsState& from, PointsState& to) const {
+    to.vp.reserve(from.vp.size());
+    for (auto j : from.vp) {
+      if (tvp[j] != to.ss.p) to.vp.push_back(j);
+    }
+    return true;
+  }
+
+  // Point can't be visited before it's inside PossibleLocations and every
+  // move visits at most one point.
+  unsigned MinExtraCost(const PointsState& s, bool& exact) const {
+    exact = s.vp.empty();
+    auto vt = s.vp;
+    unsigned min_extra_cost = vt.size();
+    for (unsigned k = 1; !vt.empty(); ++k) {
+      auto b = s.ss.PossibleLocations(k);
+      for (unsigned j = 0; j < vt.size(); ++j) {
+        if (b.Inside(tvp[vt[j]])) {
+          vt[j--] = vt.back();
+          vt.pop_back();
+          min_extra_cost = std::max<unsigned>(min_extra_cost, k + vt.size());
+        }
+      }
+    }
+    return min_extra_cost;
+  }
+};
+}  // namespace spaceship